@@ -19,6 +19,10 @@
 #ifndef WOINC_RPC_COMMAND_H_
 #define WOINC_RPC_COMMAND_H_
 
+#include <chrono>
+#include <cstddef>
+#include <string>
+
 #include <woinc/defs.h>
 #include <woinc/types.h>
 #include <woinc/version.h>
@@ -38,6 +42,18 @@ enum class COMMAND_STATUS {
 };
 
 struct Command {
+    // accumulated over all RPCs sent while executing the command
+    struct Statistics {
+        std::string rpc; // the tag of the (last) request, e.g. "get_state"
+        std::chrono::nanoseconds send = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds wait = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds receive = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds parse = std::chrono::nanoseconds::zero();
+        std::size_t bytes_sent = 0;
+        std::size_t bytes_received = 0;
+        std::size_t responses = 0; // the number of completely received responses
+    };
+
     virtual ~Command() = default;
 
     virtual COMMAND_STATUS execute(Connection &) = 0;
@@ -47,12 +63,14 @@ struct Command {
     }
 
     const std::string &error() const { return error_; }
+    const Statistics &statistics() const { return statistics_; }
 
     // see gui_rpcs[] in BOINC/client/gui_rpc_server_ops.cpp
     virtual bool requires_local_authorization() const = 0;
 
     protected:
         std::string error_;
+        Statistics statistics_;
 };
 
 template<typename REQUEST_TYPE, typename RESPONSE_TYPE, bool REQUIRE_LOCAL_AUTH>
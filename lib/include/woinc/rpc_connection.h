@@ -19,6 +19,8 @@
 #ifndef WOINC_RPC_CONNECTION_H_
 #define WOINC_RPC_CONNECTION_H_
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <iosfwd>
 #include <memory>
@@ -50,6 +52,16 @@ class Connection {
             }
         };
 
+        // connect is measured by the last call to open(), all other values by the last call to do_rpc()
+        struct Statistics {
+            std::chrono::nanoseconds connect = std::chrono::nanoseconds::zero();
+            std::chrono::nanoseconds send = std::chrono::nanoseconds::zero();
+            std::chrono::nanoseconds wait = std::chrono::nanoseconds::zero(); // until the first bytes of the response arrived
+            std::chrono::nanoseconds receive = std::chrono::nanoseconds::zero(); // from the first bytes until the EOM
+            std::size_t bytes_sent = 0;
+            std::size_t bytes_received = 0;
+        };
+
     public:
         Connection();
         virtual ~Connection();
@@ -61,6 +73,8 @@ class Connection {
 
         virtual bool is_localhost() const;
 
+        virtual const Statistics &statistics() const;
+
     protected:
         struct Impl;
         std::unique_ptr<Impl> impl_;
@@ -0,0 +1,94 @@
+/* woinc/trace.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#ifndef WOINC_TRACE_H_
+#define WOINC_TRACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+
+namespace woinc { namespace trace {
+
+// Records spans of the threads of woinc, e.g. to find out whether the periodic tasks scheduler,
+// the RPCs, the parser or the handlers are to blame for a slow UI. The spans are exported in the
+// Chrome trace event format and can be viewed with Perfetto or chrome://tracing.
+//
+// Tracing is disabled by default and a span costs a relaxed atomic load only while disabled.
+// While enabled, each thread records its spans into its own ring buffer without locking, so only
+// the latest spans of each thread are kept.
+
+void enable(bool value);
+inline bool enabled();
+
+// names the calling thread in the trace
+void thread_name(std::string name);
+
+// writes the recorded spans as JSON, the spans are kept
+void dump(std::ostream &out);
+
+// discards the recorded spans
+void clear();
+
+namespace detail {
+
+extern std::atomic<bool> enabled_flag;
+
+void record(const char *name,
+            std::chrono::steady_clock::time_point begin,
+            std::chrono::steady_clock::time_point end);
+
+}
+
+inline bool enabled() {
+    return detail::enabled_flag.load(std::memory_order_relaxed);
+}
+
+// Records the lifetime of the span, use WOINC_TRACE_SPAN.
+// The name isn't copied, therefore it must be a string literal.
+class Span {
+    public:
+        explicit Span(const char *name) : name_(enabled() ? name : nullptr) {
+            if (name_ != nullptr)
+                begin_ = std::chrono::steady_clock::now();
+        }
+
+        ~Span() {
+            if (name_ != nullptr)
+                detail::record(name_, begin_, std::chrono::steady_clock::now());
+        }
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        const char *name_;
+        std::chrono::steady_clock::time_point begin_;
+};
+
+}}
+
+#define WOINC_TRACE_CONCAT_(a, b) a##b
+#define WOINC_TRACE_SPAN_(name, line) ::woinc::trace::Span WOINC_TRACE_CONCAT_(woinc_trace_span_, line)(name)
+
+// traces the rest of the enclosing scope
+#define WOINC_TRACE_SPAN(name) WOINC_TRACE_SPAN_(name, __LINE__)
+
+#endif
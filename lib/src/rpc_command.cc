@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <set>
 #include <sstream>
 
@@ -28,6 +29,7 @@
 #endif
 
 #include <woinc/rpc_connection.h>
+#include <woinc/trace.h>
 
 #include "md5.h"
 #include "rpc_parsing.h"
@@ -58,17 +60,40 @@ constexpr COMMAND_STATUS as_status__(bool b) {
 COMMAND_STATUS do_rpc__(Connection &connection,
                         const wxml::Tree &request_tree,
                         wxml::Tree &response_tree,
-                        std::string &error_holder) {
+                        std::string &error_holder,
+                        Command::Statistics &statistics) {
     std::stringstream response;
 
+    if (!request_tree.root.children.empty())
+        statistics.rpc = request_tree.root.children.front().tag;
+
     auto rpc_result = connection.do_rpc(request_tree.str(), response);
 
+    {
+        const auto &connection_statistics = connection.statistics();
+        statistics.send += connection_statistics.send;
+        statistics.wait += connection_statistics.wait;
+        statistics.receive += connection_statistics.receive;
+        statistics.bytes_sent += connection_statistics.bytes_sent;
+        statistics.bytes_received += connection_statistics.bytes_received;
+    }
+
     if (!rpc_result) {
         error_holder = rpc_result.error;
         return map__(rpc_result.status);
     }
 
-    if (!wxml::parse_boinc_response(response_tree, response, error_holder))
+    ++statistics.responses;
+
+    auto parse_start = std::chrono::steady_clock::now();
+    bool parsed;
+    {
+        WOINC_TRACE_SPAN("xml.parse");
+        parsed = wxml::parse_boinc_response(response_tree, response, error_holder);
+    }
+    statistics.parse += std::chrono::steady_clock::now() - parse_start;
+
+    if (!parsed)
         return COMMAND_STATUS::PARSING_ERROR;
 
     if (response_tree.root.children.size() == 1
@@ -210,24 +235,34 @@ template<typename RESPONSE>
 COMMAND_STATUS do_cmd__(Connection &connection,
                         const wxml::Tree &request_tree,
                         std::string &error_holder,
+                        Command::Statistics &statistics,
                         RESPONSE &response) {
     wxml::Tree response_tree;
 
-    auto status = do_rpc__(connection, request_tree, response_tree, error_holder);
+    auto status = do_rpc__(connection, request_tree, response_tree, error_holder, statistics);
     if (status != COMMAND_STATUS::OK)
         return status;
 
-    return parse__(response_tree, response) ? COMMAND_STATUS::OK : COMMAND_STATUS::PARSING_ERROR;
+    auto parse_start = std::chrono::steady_clock::now();
+    bool parsed;
+    {
+        WOINC_TRACE_SPAN("rpc.parse_response");
+        parsed = parse__(response_tree, response);
+    }
+    statistics.parse += std::chrono::steady_clock::now() - parse_start;
+
+    return parsed ? COMMAND_STATUS::OK : COMMAND_STATUS::PARSING_ERROR;
 }
 
 template<typename RESPONSE>
 COMMAND_STATUS do_cmd__(Connection &connection,
                         const char *cmd,
                         std::string &error_holder,
+                        Command::Statistics &statistics,
                         RESPONSE &response) {
     wxml::Tree request_tree(wxml::create_boinc_request_tree());
     request_tree.root[cmd];
-    return do_cmd__(connection, request_tree, error_holder, response);
+    return do_cmd__(connection, request_tree, error_holder, statistics, response);
 }
 
 wxml::Tree set_mode_request__(const char *cmd, woinc::RUN_MODE m, double duration) {
@@ -269,7 +304,7 @@ COMMAND_STATUS AuthorizeCommand::execute(Connection &connection) {
 
         wxml::Tree response_tree;
 
-        auto status = do_rpc__(connection, request_tree, response_tree, error_);
+        auto status = do_rpc__(connection, request_tree, response_tree, error_, statistics_);
         if (status != COMMAND_STATUS::OK)
             return status;
 
@@ -286,7 +321,7 @@ COMMAND_STATUS AuthorizeCommand::execute(Connection &connection) {
 
         wxml::Tree response_tree;
 
-        auto status = do_rpc__(connection, request_tree, response_tree, error_);
+        auto status = do_rpc__(connection, request_tree, response_tree, error_, statistics_);
         if (status != COMMAND_STATUS::OK)
             return status;
 
@@ -304,27 +339,27 @@ COMMAND_STATUS ExchangeVersionsCommand::execute(Connection &connection) {
     request_node["minor"]   = request_.version.minor;
     request_node["release"] = request_.version.release;
 
-    return do_cmd__(connection, request_tree, error_, response());
+    return do_cmd__(connection, request_tree, error_, statistics_, response());
 }
 
 template<>
 COMMAND_STATUS GetCCStatusCommand::execute(Connection &connection) {
-    return do_cmd__(connection, "get_cc_status", error_, response());
+    return do_cmd__(connection, "get_cc_status", error_, statistics_, response());
 }
 
 template<>
 COMMAND_STATUS GetClientStateCommand::execute(Connection &connection) {
-    return do_cmd__(connection, "get_state", error_, response());
+    return do_cmd__(connection, "get_state", error_, statistics_, response());
 }
 
 template<>
 COMMAND_STATUS GetDiskUsageCommand::execute(Connection &connection) {
-    return do_cmd__(connection, "get_disk_usage", error_, response());
+    return do_cmd__(connection, "get_disk_usage", error_, statistics_, response());
 }
 
 template<>
 COMMAND_STATUS GetFileTransfersCommand::execute(Connection &connection) {
-    return do_cmd__(connection, "get_file_transfers", error_, response());
+    return do_cmd__(connection, "get_file_transfers", error_, statistics_, response());
 }
 
 GetGlobalPreferencesRequest::GetGlobalPreferencesRequest(GET_GLOBAL_PREFS_MODE m)
@@ -345,12 +380,12 @@ COMMAND_STATUS GetGlobalPreferencesCommand::execute(Connection &connection) {
     assert(mode);
     request_tree.root[std::string("get_global_prefs_") + mode];
 
-    return do_cmd__(connection, request_tree, error_, response());
+    return do_cmd__(connection, request_tree, error_, statistics_, response());
 }
 
 template<>
 COMMAND_STATUS GetHostInfoCommand::execute(Connection &connection) {
-    return do_cmd__(connection, "get_host_info", error_, response());
+    return do_cmd__(connection, "get_host_info", error_, statistics_, response());
 }
 
 template<>
@@ -361,7 +396,7 @@ COMMAND_STATUS GetMessagesCommand::execute(Connection &connection) {
     if (request_.translatable)
         request_node["translatable"];
 
-    return do_cmd__(connection, request_tree, error_, response());
+    return do_cmd__(connection, request_tree, error_, statistics_, response());
 }
 
 template<>
@@ -370,12 +405,12 @@ COMMAND_STATUS GetNoticesCommand::execute(Connection &connection) {
     auto &request_node = request_tree.root["get_notices"];
     request_node["seqno"] = request_.seqno;
 
-    return do_cmd__(connection, request_tree, error_, response());
+    return do_cmd__(connection, request_tree, error_, statistics_, response());
 }
 
 template<>
 COMMAND_STATUS GetProjectStatusCommand::execute(Connection &connection) {
-    return do_cmd__(connection, "get_project_status", error_, response());
+    return do_cmd__(connection, "get_project_status", error_, statistics_, response());
 }
 
 template<>
@@ -383,17 +418,17 @@ COMMAND_STATUS GetResultsCommand::execute(Connection &connection) {
     wxml::Tree request_tree(wxml::create_boinc_request_tree());
     request_tree.root["get_results"]["active_only"] = request_.active_only ? 1 : 0;
 
-    return do_cmd__(connection, request_tree, error_, response());
+    return do_cmd__(connection, request_tree, error_, statistics_, response());
 }
 
 template<>
 COMMAND_STATUS GetStatisticsCommand::execute(Connection &connection) {
-    return do_cmd__(connection, "get_statistics", error_, response());
+    return do_cmd__(connection, "get_statistics", error_, statistics_, response());
 }
 
 template<>
 COMMAND_STATUS NetworkAvailableCommand::execute(Connection &connection) {
-    return do_cmd__(connection, "network_available", error_, response());
+    return do_cmd__(connection, "network_available", error_, statistics_, response());
 }
 
 ProjectAttachRequest::ProjectAttachRequest(std::string url, std::string auth, std::string project)
@@ -411,7 +446,7 @@ COMMAND_STATUS ProjectAttachCommand::execute(Connection &connection) {
     cmd_node["authenticator"] = request().authenticator;
     cmd_node["project_name"] = request().project_name;
 
-    return do_cmd__(connection, request_tree, error_, response());
+    return do_cmd__(connection, request_tree, error_, statistics_, response());
 }
 
 ProjectOpRequest::ProjectOpRequest(PROJECT_OP o, std::string url)
@@ -440,27 +475,27 @@ COMMAND_STATUS ProjectOpCommand::execute(Connection &connection) {
     auto &cmd_node = request_tree.root[std::string("project_") + std::string(op)];
     cmd_node["project_url"] = request().master_url;
 
-    return do_cmd__(connection, request_tree, error_, response());
+    return do_cmd__(connection, request_tree, error_, statistics_, response());
 }
 
 template<>
 COMMAND_STATUS QuitCommand::execute(Connection &connection) {
-    return do_cmd__(connection, "quit", error_, response());
+    return do_cmd__(connection, "quit", error_, statistics_, response());
 }
 
 template<>
 COMMAND_STATUS ReadCCConfigCommand::execute(Connection &connection) {
-    return do_cmd__(connection, "read_cc_config", error_, response());
+    return do_cmd__(connection, "read_cc_config", error_, statistics_, response());
 }
 
 template<>
 COMMAND_STATUS ReadGlobalPreferencesOverrideCommand::execute(Connection &connection) {
-    return do_cmd__(connection, "read_global_prefs_override", error_, response());
+    return do_cmd__(connection, "read_global_prefs_override", error_, statistics_, response());
 }
 
 template<>
 COMMAND_STATUS RunBenchmarksCommand::execute(Connection &connection) {
-    return do_cmd__(connection, "run_benchmarks", error_, response());
+    return do_cmd__(connection, "run_benchmarks", error_, statistics_, response());
 }
 
 SetGpuModeRequest::SetGpuModeRequest(RUN_MODE m, double d)
@@ -471,6 +506,7 @@ COMMAND_STATUS SetGpuModeCommand::execute(Connection &connection) {
     return do_cmd__(connection,
                     set_mode_request__("set_gpu_mode", request().mode, request().duration),
                     error_,
+                    statistics_,
                     response());
 }
 
@@ -482,6 +518,7 @@ COMMAND_STATUS SetNetworkModeCommand::execute(Connection &connection) {
     return do_cmd__(connection,
                     set_mode_request__("set_network_mode", request().mode, request().duration),
                     error_,
+                    statistics_,
                     response());
 }
 
@@ -493,6 +530,7 @@ COMMAND_STATUS SetRunModeCommand::execute(Connection &connection) {
     return do_cmd__(connection,
                     set_mode_request__("set_run_mode", request().mode, request().duration),
                     error_,
+                    statistics_,
                     response());
 }
 
@@ -519,7 +557,7 @@ COMMAND_STATUS TaskOpCommand::execute(Connection &connection) {
     cmd_node["project_url"] = request().master_url;
     cmd_node["name"] = request().name;
 
-    return do_cmd__(connection, request_tree, error_, response());
+    return do_cmd__(connection, request_tree, error_, statistics_, response());
 }
 
 FileTransferOpRequest::FileTransferOpRequest(FILE_TRANSFER_OP o, std::string url, std::string n)
@@ -544,7 +582,7 @@ COMMAND_STATUS FileTransferOpCommand::execute(Connection &connection) {
     cmd_node["project_url"] = request().master_url;
     cmd_node["filename"] = request().filename;
 
-    return do_cmd__(connection, request_tree, error_, response());
+    return do_cmd__(connection, request_tree, error_, statistics_, response());
 }
 
 template<>
@@ -632,7 +670,7 @@ COMMAND_STATUS SetGlobalPreferencesCommand::execute(Connection &connection) {
         }
     }
 
-    return do_cmd__(connection, request_tree, error_, response());
+    return do_cmd__(connection, request_tree, error_, statistics_, response());
 }
 
 }}
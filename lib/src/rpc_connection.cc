@@ -19,6 +19,7 @@
 #include <woinc/rpc_connection.h>
 
 #include <cassert>
+#include <chrono>
 #include <limits>
 #include <sstream>
 
@@ -26,6 +27,8 @@
 #include <iostream>
 #endif
 
+#include <woinc/trace.h>
+
 #include "socket.h"
 #include "visibility.h"
 
@@ -47,12 +50,26 @@ class WOINC_LOCAL Connection::Impl {
 
         bool is_localhost() const;
 
+        const Connection::Statistics &statistics() const;
+
+    private:
+        Connection::Result open_(const std::string &hostname, std::uint16_t port);
+        Connection::Result do_rpc_(const std::string &request, std::ostream &response);
+
     private:
         std::unique_ptr<woinc::Socket> socket_;
         bool connected_ = false;
+        Connection::Statistics statistics_;
 };
 
 Connection::Result Connection::Impl::open(const std::string &hostname, std::uint16_t port) {
+    auto start = std::chrono::steady_clock::now();
+    auto result = open_(hostname, port);
+    statistics_.connect = std::chrono::steady_clock::now() - start;
+    return result;
+}
+
+Connection::Result Connection::Impl::open_(const std::string &hostname, std::uint16_t port) {
     if (connected_)
         close();
 
@@ -95,7 +112,14 @@ void Connection::Impl::close() {
 }
 
 Connection::Result Connection::Impl::do_rpc(const std::string &request, std::ostream &response) {
+    statistics_.send = statistics_.wait = statistics_.receive = std::chrono::nanoseconds::zero();
+    statistics_.bytes_sent = statistics_.bytes_received = 0;
+    return do_rpc_(request, response);
+}
+
+Connection::Result Connection::Impl::do_rpc_(const std::string &request, std::ostream &response) {
     char buffer[BUFFER_SIZE];
+    auto timestamp = std::chrono::steady_clock::now();
 
 #ifdef WOINC_LOG_RPC_CONNECTION
     std::cerr << "------------- REQUEST ------------\n"
@@ -104,6 +128,8 @@ Connection::Result Connection::Impl::do_rpc(const std::string &request, std::ost
 #endif
 
     {
+        WOINC_TRACE_SPAN("rpc.send");
+
         Socket::Result result = socket_->send(request.c_str(), request.size());
         if (!result)
             return Result(CONNECTION_STATUS::ERROR, std::move(result.error));
@@ -111,12 +137,19 @@ Connection::Result Connection::Impl::do_rpc(const std::string &request, std::ost
         result = socket_->send(&EOM, sizeof(EOM));
         if (!result)
             return Result(CONNECTION_STATUS::ERROR, std::move(result.error));
+
+        auto now = std::chrono::steady_clock::now();
+        statistics_.send = now - timestamp;
+        statistics_.bytes_sent = request.size() + sizeof(EOM);
+        timestamp = now;
     }
 
 #ifdef WOINC_LOG_RPC_CONNECTION
     std::cerr << "------------- RESPONSE ------------\n";
 #endif
 
+    WOINC_TRACE_SPAN("rpc.receive");
+
     bool eom = false;
     while (!eom) {
         size_t bytes_read = 0;
@@ -130,6 +163,13 @@ Connection::Result Connection::Impl::do_rpc(const std::string &request, std::ost
         if (bytes_read == 0)
             return Result(CONNECTION_STATUS::DISCONNECTED);
 
+        if (statistics_.bytes_received == 0) {
+            auto now = std::chrono::steady_clock::now();
+            statistics_.wait = now - timestamp;
+            timestamp = now;
+        }
+        statistics_.bytes_received += bytes_read;
+
 #ifdef WOINC_LOG_RPC_CONNECTION
         std::cerr.write(buffer, bytes_read);
 #endif
@@ -146,6 +186,8 @@ Connection::Result Connection::Impl::do_rpc(const std::string &request, std::ost
             return Result(CONNECTION_STATUS::ERROR);
     }
 
+    statistics_.receive = std::chrono::steady_clock::now() - timestamp;
+
 #ifdef WOINC_LOG_RPC_CONNECTION
     std::cerr << "------------- END RESPONSE ------------" << std::endl;
 #endif
@@ -157,6 +199,10 @@ bool Connection::Impl::is_localhost() const {
     return socket_->is_localhost();
 }
 
+const Connection::Statistics &Connection::Impl::statistics() const {
+    return statistics_;
+}
+
 // ---- Connection ----
 
 Connection::Connection()
@@ -183,4 +229,8 @@ bool Connection::is_localhost() const {
     return impl_->is_localhost();
 }
 
+const Connection::Statistics &Connection::statistics() const {
+    return impl_->statistics();
+}
+
 }}
@@ -0,0 +1,252 @@
+/* lib/trace.cc --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#include <woinc/trace.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "visibility.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum { BUFFER_SIZE = 4096 };
+
+struct WOINC_LOCAL Event {
+    std::atomic<const char *> name {nullptr};
+    std::atomic<std::int64_t> begin {0}; // nanoseconds since the epoch of the registry
+    std::atomic<std::int64_t> duration {0};
+};
+
+// Written by the owning thread only. The writer announces the event it's going to overwrite
+// by incrementing begun and publishes it by incrementing committed, so a reader can detect
+// the events which may have been overwritten while reading them (like a seqlock).
+struct WOINC_LOCAL Buffer {
+    explicit Buffer(std::uint32_t t) : tid(t) {}
+
+    const std::uint32_t tid;
+
+    std::atomic<std::uint64_t> begun {0};
+    std::atomic<std::uint64_t> committed {0};
+    std::array<Event, BUFFER_SIZE> events;
+
+    // guarded by the lock of the registry
+    std::string name;
+    std::uint64_t cleared = 0;
+    bool finished = false;
+};
+
+struct WOINC_LOCAL Registry {
+    std::mutex lock;
+    const Clock::time_point epoch = Clock::now();
+    std::uint32_t next_tid = 1;
+    std::vector<std::shared_ptr<Buffer>> buffers;
+};
+
+Registry &registry__() {
+    static Registry registry;
+    return registry;
+}
+
+// the buffer is created on the first recorded span only, so threads never traced don't allocate one
+struct WOINC_LOCAL ThreadState {
+    std::string name;
+    std::shared_ptr<Buffer> buffer;
+
+    ~ThreadState() {
+        if (buffer) {
+            auto &registry = registry__();
+            std::lock_guard<std::mutex> guard(registry.lock);
+            buffer->finished = true;
+        }
+    }
+};
+
+ThreadState &thread_state__() {
+    thread_local ThreadState state;
+    return state;
+}
+
+Buffer &thread_buffer__() {
+    auto &state = thread_state__();
+
+    if (!state.buffer) {
+        auto &registry = registry__();
+        std::lock_guard<std::mutex> guard(registry.lock);
+        state.buffer = std::make_shared<Buffer>(registry.next_tid++);
+        state.buffer->name = state.name;
+        registry.buffers.push_back(state.buffer);
+    }
+
+    return *state.buffer;
+}
+
+void write_escaped__(std::ostream &out, const std::string &str) {
+    const char *hex = "0123456789abcdef";
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            out << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+        else
+            out << c;
+    }
+}
+
+// the trace event format expects microseconds
+void write_us__(std::ostream &out, std::int64_t ns) {
+    auto fraction = std::to_string(ns % 1000);
+    out << ns / 1000 << '.' << std::string(3 - fraction.size(), '0') << fraction;
+}
+
+struct WOINC_LOCAL EventSnapshot {
+    const char *name;
+    std::int64_t begin;
+    std::int64_t duration;
+};
+
+std::vector<EventSnapshot> read__(const Buffer &buffer) {
+    std::vector<EventSnapshot> events;
+
+    auto committed = buffer.committed.load(std::memory_order_acquire);
+    auto first = std::max(buffer.cleared, committed > BUFFER_SIZE ? committed - BUFFER_SIZE : 0);
+
+    events.reserve(committed - first);
+    for (auto i = first; i < committed; ++i) {
+        const auto &event = buffer.events[i % BUFFER_SIZE];
+        events.push_back({
+            event.name.load(std::memory_order_relaxed),
+            event.begin.load(std::memory_order_relaxed),
+            event.duration.load(std::memory_order_relaxed)
+        });
+    }
+
+    // drop the events overwritten while reading them
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto begun = buffer.begun.load(std::memory_order_relaxed);
+    if (begun > first + BUFFER_SIZE) {
+        auto overwritten = std::min<std::uint64_t>(begun - first - BUFFER_SIZE, events.size());
+        events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(overwritten));
+    }
+
+    return events;
+}
+
+}
+
+namespace woinc { namespace trace {
+
+namespace detail {
+
+std::atomic<bool> enabled_flag {false};
+
+void record(const char *name, Clock::time_point begin, Clock::time_point end) {
+    auto &buffer = thread_buffer__();
+    const auto epoch = registry__().epoch;
+
+    auto index = buffer.committed.load(std::memory_order_relaxed);
+    auto &event = buffer.events[index % BUFFER_SIZE];
+
+    buffer.begun.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    event.name.store(name, std::memory_order_relaxed);
+    event.begin.store(std::chrono::duration_cast<std::chrono::nanoseconds>(begin - epoch).count(),
+                      std::memory_order_relaxed);
+    event.duration.store(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count(),
+                         std::memory_order_relaxed);
+
+    buffer.committed.store(index + 1, std::memory_order_release);
+}
+
+}
+
+void enable(bool value) {
+    registry__(); // the epoch must precede all recorded spans
+    detail::enabled_flag.store(value, std::memory_order_relaxed);
+}
+
+void thread_name(std::string name) {
+    auto &state = thread_state__();
+    state.name = std::move(name);
+
+    if (state.buffer) {
+        auto &registry = registry__();
+        std::lock_guard<std::mutex> guard(registry.lock);
+        state.buffer->name = state.name;
+    }
+}
+
+void dump(std::ostream &out) {
+    auto &registry = registry__();
+    std::lock_guard<std::mutex> guard(registry.lock);
+
+    bool first = true;
+    auto begin_event = [&]() -> std::ostream & {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        return out;
+    };
+
+    out << "{\"traceEvents\":[";
+
+    for (const auto &buffer : registry.buffers) {
+        if (!buffer->name.empty()) {
+            begin_event() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"args\":{\"name\":\"";
+            write_escaped__(out, buffer->name);
+            out << "\"}}";
+        }
+
+        for (const auto &event : read__(*buffer)) {
+            begin_event() << "{\"name\":\"";
+            write_escaped__(out, event.name);
+            out << "\",\"cat\":\"woinc\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":";
+            write_us__(out, event.begin);
+            out << ",\"dur\":";
+            write_us__(out, event.duration);
+            out << "}";
+        }
+    }
+
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void clear() {
+    auto &registry = registry__();
+    std::lock_guard<std::mutex> guard(registry.lock);
+
+    registry.buffers.erase(std::remove_if(registry.buffers.begin(), registry.buffers.end(), [](const auto &buffer) {
+        return buffer->finished;
+    }), registry.buffers.end());
+
+    for (auto &buffer : registry.buffers)
+        buffer->cleared = buffer->committed.load(std::memory_order_acquire);
+}
+
+}}
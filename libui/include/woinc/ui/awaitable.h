@@ -0,0 +1,149 @@
+/* woinc/ui/awaitable.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#ifndef WOINC_UI_AWAITABLE_H_
+#define WOINC_UI_AWAITABLE_H_
+
+// Awaitable variants of the async commands of the controller for C++20 coroutines, e.g.
+//
+//   bool success = co_await woinc::ui::async_task_op(controller, host, op, master_url, task_name, executor);
+//
+// The coroutine is resumed by the executor (see woinc/ui/completion.h) or, without an executor,
+// by the thread of the host. co_await returns the result of the command or rethrows its error.
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+
+#include <coroutine>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <woinc/ui/completion.h>
+#include <woinc/ui/controller.h>
+
+namespace woinc { namespace ui {
+
+template<typename RESULT>
+class CommandAwaitable {
+    public:
+        typedef std::function<void(Completion<RESULT>, Executor)> Command;
+
+        CommandAwaitable(Command command, Executor executor)
+            : command_(std::move(command)), executor_(std::move(executor)) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            // the coroutine may be resumed and this awaitable destroyed before the command returns
+            auto command = std::move(command_);
+            command([this, handle](Result<RESULT> result) {
+                result_.emplace(std::move(result));
+                handle.resume();
+            }, std::move(executor_));
+        }
+
+        RESULT await_resume() {
+            return std::move(*result_).value();
+        }
+
+    private:
+        Command command_;
+        Executor executor_;
+        std::optional<Result<RESULT>> result_;
+};
+
+inline CommandAwaitable<bool> async_file_transfer_op(Controller &controller, std::string host, FILE_TRANSFER_OP op,
+                                                     std::string master_url, std::string filename,
+                                                     Executor executor = Executor()) {
+    return {[&controller, host = std::move(host), op, master_url = std::move(master_url),
+             filename = std::move(filename)](Completion<bool> completion, Executor ex) {
+        controller.file_transfer_op(host, op, master_url, filename, std::move(completion), std::move(ex));
+    }, std::move(executor)};
+}
+
+inline CommandAwaitable<bool> async_project_op(Controller &controller, std::string host, PROJECT_OP op,
+                                               std::string master_url, Executor executor = Executor()) {
+    return {[&controller, host = std::move(host), op, master_url = std::move(master_url)](
+            Completion<bool> completion, Executor ex) {
+        controller.project_op(host, op, master_url, std::move(completion), std::move(ex));
+    }, std::move(executor)};
+}
+
+inline CommandAwaitable<bool> async_task_op(Controller &controller, std::string host, TASK_OP op,
+                                            std::string master_url, std::string task_name,
+                                            Executor executor = Executor()) {
+    return {[&controller, host = std::move(host), op, master_url = std::move(master_url),
+             task_name = std::move(task_name)](Completion<bool> completion, Executor ex) {
+        controller.task_op(host, op, master_url, task_name, std::move(completion), std::move(ex));
+    }, std::move(executor)};
+}
+
+inline CommandAwaitable<GlobalPreferences> async_load_global_preferences(Controller &controller, std::string host,
+                                                                         GET_GLOBAL_PREFS_MODE mode,
+                                                                         Executor executor = Executor()) {
+    return {[&controller, host = std::move(host), mode](Completion<GlobalPreferences> completion, Executor ex) {
+        controller.load_global_preferences(host, mode, std::move(completion), std::move(ex));
+    }, std::move(executor)};
+}
+
+inline CommandAwaitable<bool> async_save_global_preferences(Controller &controller, std::string host,
+                                                            GlobalPreferences prefs, GlobalPreferencesMask mask,
+                                                            Executor executor = Executor()) {
+    return {[&controller, host = std::move(host), prefs = std::move(prefs), mask = std::move(mask)](
+            Completion<bool> completion, Executor ex) {
+        controller.save_global_preferences(host, prefs, mask, std::move(completion), std::move(ex));
+    }, std::move(executor)};
+}
+
+inline CommandAwaitable<bool> async_read_global_prefs_override(Controller &controller, std::string host,
+                                                               Executor executor = Executor()) {
+    return {[&controller, host = std::move(host)](Completion<bool> completion, Executor ex) {
+        controller.read_global_prefs_override(host, std::move(completion), std::move(ex));
+    }, std::move(executor)};
+}
+
+inline CommandAwaitable<bool> async_run_mode(Controller &controller, std::string host, RUN_MODE mode,
+                                             Executor executor = Executor()) {
+    return {[&controller, host = std::move(host), mode](Completion<bool> completion, Executor ex) {
+        controller.run_mode(host, mode, std::move(completion), std::move(ex));
+    }, std::move(executor)};
+}
+
+inline CommandAwaitable<bool> async_gpu_mode(Controller &controller, std::string host, RUN_MODE mode,
+                                             Executor executor = Executor()) {
+    return {[&controller, host = std::move(host), mode](Completion<bool> completion, Executor ex) {
+        controller.gpu_mode(host, mode, std::move(completion), std::move(ex));
+    }, std::move(executor)};
+}
+
+inline CommandAwaitable<bool> async_network_mode(Controller &controller, std::string host, RUN_MODE mode,
+                                                 Executor executor = Executor()) {
+    return {[&controller, host = std::move(host), mode](Completion<bool> completion, Executor ex) {
+        controller.network_mode(host, mode, std::move(completion), std::move(ex));
+    }, std::move(executor)};
+}
+
+}}
+
+#endif
+#endif
+
+#endif
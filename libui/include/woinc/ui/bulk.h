@@ -0,0 +1,78 @@
+/* woinc/ui/bulk.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#ifndef WOINC_UI_BULK_H_
+#define WOINC_UI_BULK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace woinc { namespace ui {
+
+// A task of a host to be operated on by a bulk operation, see Controller::bulk_task_op()
+struct TaskTarget {
+    std::string host;
+    std::string master_url;
+    std::string task_name;
+};
+
+// A host to be added by Controller::add_hosts(), the host is authorized if a password is given
+struct HostTarget {
+    std::string host;
+    std::string url;
+    std::uint16_t port = 31416; // the default GUI RPC port of the BOINC client
+    std::string password;
+};
+
+template<typename TARGET>
+struct TargetResult {
+    TARGET target;
+    bool success = false;
+    std::string error; // set if the operation failed
+};
+
+// the results are in the same order as the passed targets
+template<typename TARGET>
+struct TargetResults {
+    std::vector<TargetResult<TARGET>> results;
+
+    std::size_t failed() const {
+        std::size_t count = 0;
+        for (const auto &result : results)
+            count += result.success ? 0 : 1;
+        return count;
+    }
+};
+
+typedef TargetResult<TaskTarget> TaskTargetResult;
+typedef TargetResults<TaskTarget> BulkResult;
+
+typedef TargetResult<HostTarget> HostTargetResult;
+typedef TargetResults<HostTarget> AddHostsResult;
+
+// called after each processed target with the number of processed targets and the number of all targets;
+// without an executor, it's called by the threads of the hosts, so the calls may overlap and be out of order
+typedef std::function<void(std::size_t processed, std::size_t total)> BulkProgress;
+
+}}
+
+#endif
@@ -0,0 +1,67 @@
+/* woinc/ui/completion.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#ifndef WOINC_UI_COMPLETION_H_
+#define WOINC_UI_COMPLETION_H_
+
+#include <exception>
+#include <functional>
+#include <utility>
+
+namespace woinc { namespace ui {
+
+// The result of an async command, either its value or the error preventing it.
+template<typename RESULT>
+class Result {
+    public:
+        explicit Result(RESULT value) : value_(std::move(value)) {}
+        explicit Result(std::exception_ptr error) : error_(std::move(error)) {}
+
+        bool ok() const { return !error_; }
+        explicit operator bool() const { return ok(); }
+
+        // rethrows the error like std::future::get()
+        const RESULT &value() const & { rethrow_(); return value_; }
+        RESULT &&value() && { rethrow_(); return std::move(value_); }
+
+        const std::exception_ptr &error() const { return error_; }
+
+    private:
+        void rethrow_() const {
+            if (error_)
+                std::rethrow_exception(error_);
+        }
+
+    private:
+        RESULT value_ {};
+        std::exception_ptr error_;
+};
+
+template<typename RESULT>
+using Completion = std::function<void(Result<RESULT>)>;
+
+// Runs the passed function, e.g. by posting it into an event loop. Without an executor,
+// the completions are called by the thread of the host executing the command or, if the
+// command is dropped because the host is removed, by the thread removing the host. So
+// they should return quickly and must not call a blocking method of the controller.
+typedef std::function<void(std::function<void()>)> Executor;
+
+}}
+
+#endif
@@ -19,14 +19,20 @@
 #ifndef WOINC_UI_CONTROLLER_H_
 #define WOINC_UI_CONTROLLER_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <future>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include <woinc/ui/bulk.h>
+#include <woinc/ui/completion.h>
 #include <woinc/ui/defs.h>
 #include <woinc/ui/error.h>
 #include <woinc/ui/handler.h>
+#include <woinc/ui/metrics.h>
+#include <woinc/ui/state.h>
 
 namespace woinc { namespace ui {
 
@@ -51,6 +57,12 @@ class Controller {
         virtual void register_handler(PeriodicTaskHandler *handler);
         virtual void deregister_handler(PeriodicTaskHandler *handler);
 
+        virtual void register_handler(DeltaHandler *handler);
+        virtual void deregister_handler(DeltaHandler *handler);
+
+        virtual void register_handler(MetricsHandler *handler);
+        virtual void deregister_handler(MetricsHandler *handler);
+
     public: // basic host handling
 
         // TODO rename to (dis)connect_host? is host the correct name or would we connect to clients instead?
@@ -60,6 +72,23 @@ class Controller {
                               const std::string &url,
                               std::uint16_t port);
 
+        // Adds the hosts and connects to them like add_host(), the hosts with a password are authorized
+        // afterwards by the controller, so the handlers shouldn't authorize them again. A host is processed
+        // successfully if it's connected and, if a password is given, authorized.
+        // Invalid hosts, e.g. already registered ones, don't throw but fail their own result only.
+        // The progress is called after each processed host, with the executor if one is given.
+        virtual std::future<AddHostsResult> add_hosts(std::vector<HostTarget> hosts,
+                                                      BulkProgress progress = BulkProgress());
+        virtual void add_hosts(std::vector<HostTarget> hosts,
+                               Completion<AddHostsResult> completion, Executor executor = Executor(),
+                               BulkProgress progress = BulkProgress());
+
+        // The connects of all added hosts share a pool of threads limited to the given number (16 by default),
+        // because a connect may block for a long time (see man 2 connect).
+        virtual void max_concurrent_connects(std::size_t max_connects);
+        virtual std::size_t max_concurrent_connects() const;
+
+        // If the job queue of the host is full, a QueueFullException may be thrown (see QueueOverflowPolicy)
         virtual void authorize_host(const std::string &host,
                                     const std::string &password);
 
@@ -73,13 +102,67 @@ class Controller {
         virtual void periodic_task_interval(PeriodicTask task, int seconds);
         virtual int periodic_task_interval(PeriodicTask task) const;
 
+        // The interval of a host is taken from the host, its group or the global intervals, in this order.
+        // An interval of 0 removes the override of the host or group.
+        virtual void periodic_task_interval(const std::string &host, PeriodicTask task, int seconds);
+        virtual void group_periodic_task_interval(const std::string &group, PeriodicTask task, int seconds);
+        // returns the effective interval of the host
+        virtual int periodic_task_interval(const std::string &host, PeriodicTask task) const;
+
+        // an empty group removes the host from its group
+        virtual void host_group(const std::string &host, const std::string &group);
+        virtual std::string host_group(const std::string &host) const;
+
         virtual void schedule_periodic_tasks(const std::string &host, bool value);
 
         virtual void reschedule_now(const std::string &host, PeriodicTask task);
 
         virtual void active_only_tasks(const std::string &host, bool value);
 
+    public: // subscriptions
+
+        // Subscribes the handler to the entity polled by the periodic task of the host, which shall not be older than
+        // max_staleness seconds; 0 means the configured interval of the periodic task.
+        // As long as there isn't any subscription, all periodic tasks are scheduled at their configured intervals.
+        // Otherwise only the subscribed periodic tasks are scheduled at the smallest requested staleness, while
+        // hosts without subscriptions are polled for their cc status only.
+        // Subscribing again updates the requested staleness, deregistering the handler removes its subscriptions.
+        virtual void subscribe(const PeriodicTaskHandler *handler, const std::string &host,
+                               PeriodicTask task, int max_staleness = 0);
+        virtual void unsubscribe(const PeriodicTaskHandler *handler, const std::string &host, PeriodicTask task);
+        // removes all subscriptions of the handler to the host
+        virtual void unsubscribe(const PeriodicTaskHandler *handler, const std::string &host);
+
+    public: // state of the hosts
+
+        // returns the last received state of the host, e.g. for handlers registered after the host was added
+        virtual HostState snapshot(const std::string &host) const;
+
+        // returns the number of received updates of the entity, may be used to skip unchanged entities
+        virtual std::uint64_t version(const std::string &host, Entity entity) const;
+
+    public: // metrics
+
+        // returns the latencies, sizes and errors of the RPCs and the job queue counters of all hosts
+        virtual Metrics metrics() const;
+
+    public: // job queue handling
+
+        // limits the number of queued jobs of the host, a capacity of 0 means unlimited
+        virtual void job_queue_capacity(const std::string &host, std::size_t capacity,
+                                        QueueOverflowPolicy policy = QueueOverflowPolicy::DROP_OLDEST_PERIODIC);
+
+        // queued jobs of the host waiting longer than the given number of seconds are dropped
+        // instead of being executed, 0 disables dropping
+        virtual void job_staleness_limit(const std::string &host, int seconds);
+
+        // limits the RPCs sent to the host by the periodic tasks and the commands below,
+        // see RateLimit; the limit applies to the RPCs sent after setting it
+        virtual void rate_limit(const std::string &host, RateLimit limit);
+        virtual RateLimit rate_limit(const std::string &host) const;
+
     public: // commands to the client; all of those commands are async
+        // If the job queue of the host is full, a QueueFullException may be thrown (see QueueOverflowPolicy)
 
         // TODO shouldn't these commands be const?
 
@@ -100,6 +183,53 @@ class Controller {
         virtual std::future<bool> gpu_mode(const std::string &host, RUN_MODE mode);
         virtual std::future<bool> network_mode(const std::string &host, RUN_MODE mode);
 
+    public: // bulk operations
+
+        // Executes the task operation on all targets and returns the result for each target.
+        // The targets are grouped by host and the hosts process their targets in parallel. As the GUI RPC
+        // protocol of BOINC doesn't support pipelining, the RPCs of a host are sent one after the other;
+        // to not block other commands for too long, a host executes at most max_targets_per_job targets
+        // before giving other queued jobs a chance.
+        // Unknown hosts or full job queues don't throw, but fail the targets of the affected host.
+        // The progress is called after each processed target, with the executor if one is given.
+        virtual std::future<BulkResult> bulk_task_op(TASK_OP op, std::vector<TaskTarget> targets,
+                                                     BulkProgress progress = BulkProgress(),
+                                                     std::size_t max_targets_per_job = 16);
+        virtual void bulk_task_op(TASK_OP op, std::vector<TaskTarget> targets,
+                                  Completion<BulkResult> completion, Executor executor = Executor(),
+                                  BulkProgress progress = BulkProgress(),
+                                  std::size_t max_targets_per_job = 16);
+
+    public: // the same commands passing their result to a completion instead of a future
+        // The completion is called with the executor (see woinc/ui/completion.h), it isn't called
+        // if the controller is shut down before the command is executed.
+        // See woinc/ui/awaitable.h for awaiting the commands in C++20 coroutines.
+
+        virtual void file_transfer_op(const std::string &host, FILE_TRANSFER_OP op,
+                                      const std::string &master_url, const std::string &filename,
+                                      Completion<bool> completion, Executor executor = Executor());
+        virtual void project_op(const std::string &host, PROJECT_OP op, const std::string &master_url,
+                                Completion<bool> completion, Executor executor = Executor());
+        virtual void task_op(const std::string &host, TASK_OP op, const std::string &master_url, const std::string &task_name,
+                             Completion<bool> completion, Executor executor = Executor());
+
+        virtual void load_global_preferences(const std::string &host, GET_GLOBAL_PREFS_MODE mode,
+                                             Completion<GlobalPreferences> completion, Executor executor = Executor());
+        virtual void save_global_preferences(const std::string &host,
+                                             const GlobalPreferences &prefs,
+                                             const GlobalPreferencesMask &mask,
+                                             Completion<bool> completion, Executor executor = Executor());
+
+        virtual void read_global_prefs_override(const std::string &host,
+                                                Completion<bool> completion, Executor executor = Executor());
+
+        virtual void run_mode(const std::string &host, RUN_MODE mode,
+                              Completion<bool> completion, Executor executor = Executor());
+        virtual void gpu_mode(const std::string &host, RUN_MODE mode,
+                              Completion<bool> completion, Executor executor = Executor());
+        virtual void network_mode(const std::string &host, RUN_MODE mode,
+                                  Completion<bool> completion, Executor executor = Executor());
+
     private:
         struct Impl;
         std::unique_ptr<Impl> impl_;
@@ -42,6 +42,30 @@ enum class PeriodicTask {
     GET_TASKS
 };
 
+// the entities cached per host, see HostState
+enum class Entity {
+    CC_STATUS,
+    CLIENT_STATE,
+    DISK_USAGE,
+    FILE_TRANSFERS,
+    PROJECTS,
+    STATISTICS,
+    TASKS
+};
+
+// what to do if a job is scheduled for a host whose job queue is full
+enum class QueueOverflowPolicy {
+    DROP_OLDEST_PERIODIC, // drop the oldest queued periodic job, reject the new job if there is none
+    REJECT,               // reject the new job
+    BLOCK                 // block until there is space in the queue; periodic jobs are rejected instead
+};
+
+// limits the RPCs sent to a host, periodic and user triggered ones alike
+struct RateLimit {
+    double requests_per_second = 0; // 0 means unlimited
+    unsigned int burst = 1;         // the number of RPCs which may be sent at once after being idle
+};
+
 }}
 
 #endif
@@ -0,0 +1,94 @@
+/* woinc/ui/delta.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef WOINC_UI_DELTA_H_
+#define WOINC_UI_DELTA_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <woinc/types.h>
+
+namespace woinc { namespace ui {
+
+// Each bit of a field mask stands for a group of related fields of an entity. With the full
+// structures exposed (see WOINC_EXPOSE_FULL_STRUCTURES), their additional fields are compared too.
+typedef std::uint32_t FieldMask;
+
+struct TaskFields {
+    enum : FieldMask {
+        STATE          = 1 << 0, // state, exit_status, signal
+        FLAGS          = 1 << 1, // the boolean flags, e.g. suspended_via_gui or ready_to_report
+        ESTIMATES      = 1 << 2, // estimated_cpu_time_remaining
+        FINAL_TIMES    = 1 << 3, // final_cpu_time, final_elapsed_time
+        SCHEDULING     = 1 << 4, // resources, scheduler_wait_reason
+        DEADLINES      = 1 << 5, // received_time, report_deadline
+        ACTIVE_TASK    = 1 << 6, // the active task (dis)appeared or its (scheduler) state changed
+        PROGRESS       = 1 << 7, // fraction_done, progress_rate, elapsed, current and checkpoint cpu time
+        RESOURCE_USAGE = 1 << 8, // working set, swap size, bytes sent and received
+        OTHER          = 1 << 9  // all remaining fields, e.g. wu_name or version_num
+    };
+};
+
+struct ProjectFields {
+    enum : FieldMask {
+        STATUS         = 1 << 0, // the boolean flags and sched_rpc_pending
+        CREDIT         = 1 << 1, // user and host credits
+        SCHEDULING     = 1 << 2, // resource_share, sched_priority, elapsed_time
+        JOBS           = 1 << 3, // njobs_success, njobs_error
+        BACKOFFS       = 1 << 4, // rpc times, backoffs and failure counters
+        ACCOUNT        = 1 << 5, // names, venue, hostid, external_cpid, gui urls
+        DISK_USAGE     = 1 << 6, // desired_disk_usage, project_files_downloaded_time
+        OTHER          = 1 << 7  // all remaining fields, which are exposed by full structures only (e.g. rec)
+    };
+};
+
+struct FileTransferFields {
+    enum : FieldMask {
+        STATUS         = 1 << 0, // status, project_backoff
+        PROGRESS       = 1 << 1, // the active transfer (dis)appeared, bytes_xferred, xfer_speed
+        RETRIES        = 1 << 2, // the persistent transfer state: time_so_far, next_request_time, ...
+        OTHER          = 1 << 3  // all remaining fields, e.g. nbytes or project_name
+    };
+};
+
+// The changes of keyed entities between two consecutive updates of a host.
+// Tasks and file transfers are keyed by project_url and name, projects by their master_url.
+template<typename ENTITY>
+struct Delta {
+    struct Change {
+        ENTITY entity; // the new state of the entity
+        FieldMask fields;
+    };
+
+    std::vector<ENTITY> added;
+    std::vector<ENTITY> removed; // the last known state of the removed entities
+    std::vector<Change> changed;
+
+    bool empty() const {
+        return added.empty() && removed.empty() && changed.empty();
+    }
+};
+
+typedef Delta<woinc::FileTransfer> FileTransfersDelta;
+typedef Delta<woinc::Project>      ProjectsDelta;
+typedef Delta<woinc::Task>         TasksDelta;
+
+}}
+
+#endif
@@ -25,6 +25,7 @@ namespace woinc { namespace ui {
 
 struct ShutdownException {};
 struct UnknownHostException { std::string host; };
+struct QueueFullException { std::string host; };
 
 }}
 
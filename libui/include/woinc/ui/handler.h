@@ -19,10 +19,14 @@
 #ifndef WOINC_UI_HANDLER_H_
 #define WOINC_UI_HANDLER_H_
 
+#include <chrono>
+#include <memory>
 #include <string>
 
 #include <woinc/types.h>
 #include <woinc/ui/defs.h>
+#include <woinc/ui/delta.h>
+#include <woinc/ui/metrics.h>
 
 namespace woinc { namespace ui {
 
@@ -58,20 +62,57 @@ struct HostHandler {
  *
  * This handler will not be called more than once at the same time
  * and not concurrently to HostHandler::on_host_removed().
+ *
+ * The entities are moved out of the responses and shared with the other handlers
+ * and the state cache of the controller, so they must not be modified. Keep the
+ * pointer to use an entity later or in another thread instead of copying it.
+ *
+ * An update of the client state is followed by updates of the projects and tasks
+ * contained in it, which reset the intervals of the corresponding periodic tasks.
  */
 // TODO Shouldn't this be (Periodic/Model)Update(s)Handler? The consumer doesn't care about periodic tasks at all.
 struct PeriodicTaskHandler {
     virtual ~PeriodicTaskHandler() = default;
 
-    virtual void on_update(const std::string & /*host*/, const woinc::CCStatus &      /*cc_status*/) {};
-    virtual void on_update(const std::string & /*host*/, const woinc::ClientState &   /*client_state*/) {};
-    virtual void on_update(const std::string & /*host*/, const woinc::DiskUsage &     /*disk_usage*/) {};
-    virtual void on_update(const std::string & /*host*/, const woinc::FileTransfers & /*file_transfers*/) {};
-    virtual void on_update(const std::string & /*host*/, const woinc::Messages &      /*messages*/) {};
-    virtual void on_update(const std::string & /*host*/, const woinc::Notices &       /*notices*/, bool /*refreshed*/) {};
-    virtual void on_update(const std::string & /*host*/, const woinc::Projects &      /*projects*/) {};
-    virtual void on_update(const std::string & /*host*/, const woinc::Statistics &    /*statistics*/) {};
-    virtual void on_update(const std::string & /*host*/, const woinc::Tasks &         /*tasks*/) {};
+    virtual void on_update(const std::string & /*host*/, std::shared_ptr<const woinc::CCStatus>      /*cc_status*/) {};
+    virtual void on_update(const std::string & /*host*/, std::shared_ptr<const woinc::ClientState>   /*client_state*/) {};
+    virtual void on_update(const std::string & /*host*/, std::shared_ptr<const woinc::DiskUsage>     /*disk_usage*/) {};
+    virtual void on_update(const std::string & /*host*/, std::shared_ptr<const woinc::FileTransfers> /*file_transfers*/) {};
+    virtual void on_update(const std::string & /*host*/, std::shared_ptr<const woinc::Messages>      /*messages*/) {};
+    virtual void on_update(const std::string & /*host*/, std::shared_ptr<const woinc::Notices>       /*notices*/, bool /*refreshed*/) {};
+    virtual void on_update(const std::string & /*host*/, std::shared_ptr<const woinc::Projects>      /*projects*/) {};
+    virtual void on_update(const std::string & /*host*/, std::shared_ptr<const woinc::Statistics>    /*statistics*/) {};
+    virtual void on_update(const std::string & /*host*/, std::shared_ptr<const woinc::Tasks>         /*tasks*/) {};
+};
+
+/*
+ * Handles the changes of keyed entities between two consecutive updates, see woinc/ui/delta.h.
+ *
+ * The deltas are computed only while at least one delta handler is registered, so the first
+ * delta after registering the first handler reports all entities as added. Empty deltas are
+ * not reported. The same guarantees as for the PeriodicTaskHandler apply.
+ */
+struct DeltaHandler {
+    virtual ~DeltaHandler() = default;
+
+    virtual void on_delta(const std::string & /*host*/, const FileTransfersDelta & /*delta*/) {};
+    virtual void on_delta(const std::string & /*host*/, const ProjectsDelta &      /*delta*/) {};
+    virtual void on_delta(const std::string & /*host*/, const TasksDelta &         /*delta*/) {};
+};
+
+/*
+ * Receives each single measurement, e.g. to forward it to a monitoring system, while
+ * Controller::metrics() returns the aggregated measurements.
+ *
+ * This handler is called by the threads of the hosts, so it must be implemented threadsafe
+ * and should return quickly.
+ */
+struct MetricsHandler {
+    virtual ~MetricsHandler() = default;
+
+    virtual void on_connect(const std::string & /*host*/, std::chrono::nanoseconds /*duration*/, bool /*success*/) {};
+    virtual void on_queue_wait(const std::string & /*host*/, std::chrono::nanoseconds /*duration*/) {};
+    virtual void on_rpc(const std::string & /*host*/, const RpcSample & /*sample*/) {};
 };
 
 }}
@@ -0,0 +1,49 @@
+/* woinc/ui/inventory.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#ifndef WOINC_UI_INVENTORY_H_
+#define WOINC_UI_INVENTORY_H_
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <woinc/ui/bulk.h>
+
+namespace woinc { namespace ui {
+
+// Reads the hosts to be added by Controller::add_hosts() from an inventory with one host per line:
+//
+//   <host> <url> [<port> [<password source>]]
+//
+// Empty lines and lines starting with '#' are ignored. The password source is one of:
+//
+//   env:<variable>  the value of the environment variable
+//   file:<path>     the first line of the file
+//   <password>      the password itself, prefix it with "literal:" if it starts with "env:" or "file:"
+//
+// Throws std::invalid_argument for malformed lines and unavailable password sources.
+std::vector<HostTarget> load_inventory(std::istream &in);
+
+// Throws std::runtime_error if the file can't be read.
+std::vector<HostTarget> load_inventory(const std::string &path);
+
+}}
+
+#endif
@@ -0,0 +1,127 @@
+/* woinc/ui/metrics.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#ifndef WOINC_UI_METRICS_H_
+#define WOINC_UI_METRICS_H_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace woinc { namespace ui {
+
+// Records durations with a resolution of microseconds into logarithmic buckets, which are linearly
+// subdivided into 16 sub buckets (like the HdrHistogram), so the relative error of the percentiles
+// is at most 1/16. Durations longer than ~19 hours are recorded as ~19 hours.
+class LatencyHistogram {
+    public:
+        void record(std::chrono::nanoseconds duration);
+        void merge(const LatencyHistogram &other);
+
+        std::uint64_t count() const { return count_; }
+
+        std::chrono::microseconds min() const;
+        std::chrono::microseconds max() const;
+        std::chrono::microseconds mean() const;
+
+        // percentile in [0, 100], returns the upper bound of the bucket containing the percentile
+        std::chrono::microseconds percentile(double percentile) const;
+
+    private:
+        enum {
+            SUB_BUCKET_BITS = 4,
+            SUB_BUCKETS = 1 << SUB_BUCKET_BITS,
+            MAX_MSB = 35,
+            BUCKETS = (MAX_MSB - SUB_BUCKET_BITS + 2) * SUB_BUCKETS
+        };
+
+        static std::size_t index_(std::uint64_t value);
+        static std::uint64_t upper_bound_(std::size_t index);
+
+    private:
+        std::array<std::uint64_t, BUCKETS> counts_ {{}};
+        std::uint64_t count_ = 0;
+        std::uint64_t min_ = 0;
+        std::uint64_t max_ = 0;
+        std::uint64_t sum_ = 0;
+};
+
+// the latencies contain the completed phases of the RPCs only, the failed RPCs are counted by errors
+struct CommandMetrics {
+    LatencyHistogram send;
+    LatencyHistogram wait;    // from the sent request until the first bytes of the response arrived
+    LatencyHistogram receive; // from the first until the last bytes of the response
+    LatencyHistogram parse;
+
+    std::uint64_t bytes_sent = 0;
+    std::uint64_t bytes_received = 0;
+
+    std::uint64_t errors = 0;
+};
+
+struct HostMetrics {
+    LatencyHistogram connect;
+    std::uint64_t connection_errors = 0;
+
+    // the time the jobs waited in the job queue of the host before being executed
+    LatencyHistogram queue_wait;
+
+    // keyed by the name of the RPC, e.g. "get_state"
+    std::map<std::string, CommandMetrics> commands;
+
+    // see Controller::job_queue_capacity() and Controller::job_staleness_limit()
+    std::uint64_t jobs_rejected = 0;
+    std::uint64_t jobs_dropped_overflow = 0;
+    std::uint64_t jobs_dropped_stale = 0;
+};
+
+// keyed by the host name
+typedef std::map<std::string, HostMetrics> Metrics;
+
+// the phases of an RPC in the order of their execution
+enum class RpcPhase {
+    NONE,
+    SEND,
+    WAIT,
+    RECEIVE,
+    PARSE
+};
+
+// a single execution of a command, see MetricsHandler
+struct RpcSample {
+    std::string rpc;
+    bool success = false;
+    // the last completed phase, the durations of the following phases are zero
+    RpcPhase completed = RpcPhase::NONE;
+
+    std::chrono::nanoseconds send = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds wait = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds receive = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds parse = std::chrono::nanoseconds::zero();
+
+    std::size_t bytes_sent = 0;
+    std::size_t bytes_received = 0;
+};
+
+}}
+
+#endif
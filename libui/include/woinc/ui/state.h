@@ -0,0 +1,53 @@
+/* woinc/ui/state.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef WOINC_UI_STATE_H_
+#define WOINC_UI_STATE_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include <woinc/types.h>
+#include <woinc/ui/defs.h>
+
+namespace woinc { namespace ui {
+
+// The last received state of a host. The entities are immutable and shared with all other
+// snapshots containing the same version of an entity, so taking a snapshot is cheap.
+// Entities which haven't been received yet are nullptr.
+struct HostState {
+    std::shared_ptr<const woinc::CCStatus>      cc_status;
+    std::shared_ptr<const woinc::ClientState>   client_state;
+    std::shared_ptr<const woinc::DiskUsage>     disk_usage;
+    std::shared_ptr<const woinc::FileTransfers> file_transfers;
+    std::shared_ptr<const woinc::Projects>      projects;
+    std::shared_ptr<const woinc::Statistics>    statistics;
+    std::shared_ptr<const woinc::Tasks>         tasks;
+
+    // the number of received updates per entity, indexed by Entity
+    std::array<std::uint64_t, 7> versions {{}};
+
+    std::uint64_t version(Entity entity) const {
+        return versions.at(static_cast<std::size_t>(entity));
+    }
+};
+
+}}
+
+#endif
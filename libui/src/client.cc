@@ -18,8 +18,14 @@
 
 #include "client.h"
 
+#include <chrono>
+
 namespace woinc { namespace ui {
 
+Client::Client(MetricsRecorder &metrics_recorder, RateLimiter &rate_limiter)
+    : metrics_recorder_(metrics_recorder), rate_limiter_(rate_limiter)
+{}
+
 Client::~Client() {
     disconnect();
 }
@@ -30,6 +36,8 @@ bool Client::connect(const std::string &host, std::uint16_t port) {
     host_ = host;
     connected_ = rpc_connection_.open(host, port);
 
+    metrics_recorder_.record_connect(rpc_connection_.statistics().connect, connected_);
+
     return connected_;
 }
 
@@ -41,14 +49,44 @@ void Client::disconnect() {
 }
 
 woinc::rpc::COMMAND_STATUS Client::execute(woinc::rpc::Command &cmd) {
-    if (connected_)
-        return cmd.execute(rpc_connection_);
-    else
+    if (!connected_)
         return woinc::rpc::COMMAND_STATUS::DISCONNECTED;
+
+    // the limiter is only shut down together with the host
+    if (!rate_limiter_.acquire())
+        return woinc::rpc::COMMAND_STATUS::DISCONNECTED;
+
+    auto status = cmd.execute(rpc_connection_);
+
+    const auto &statistics = cmd.statistics();
+    if (!statistics.rpc.empty()) { // nothing was sent otherwise
+        RpcSample sample;
+        sample.rpc = statistics.rpc;
+        sample.success = status == woinc::rpc::COMMAND_STATUS::OK;
+        if (statistics.responses > 0)
+            sample.completed = status == woinc::rpc::COMMAND_STATUS::PARSING_ERROR ? RpcPhase::RECEIVE : RpcPhase::PARSE;
+        else if (statistics.bytes_received > 0)
+            sample.completed = RpcPhase::WAIT;
+        else if (statistics.bytes_sent > 0)
+            sample.completed = RpcPhase::SEND;
+        sample.send = statistics.send;
+        sample.wait = statistics.wait;
+        sample.receive = statistics.receive;
+        sample.parse = statistics.parse;
+        sample.bytes_sent = statistics.bytes_sent;
+        sample.bytes_received = statistics.bytes_received;
+        metrics_recorder_.record_rpc(sample);
+    }
+
+    return status;
 }
 
 const std::string &Client::host() const {
     return host_;
 }
 
+MetricsRecorder &Client::metrics_recorder() {
+    return metrics_recorder_;
+}
+
 }}
@@ -25,6 +25,8 @@
 #include <woinc/rpc_command.h>
 #include <woinc/rpc_connection.h>
 
+#include "metrics_recorder.h"
+#include "rate_limiter.h"
 #include "visibility.h"
 
 namespace woinc { namespace ui {
@@ -32,6 +34,7 @@ namespace woinc { namespace ui {
 // The client is not threadsafe! Should only be called by the worker thread for this host.
 class WOINCUI_LOCAL Client {
     public:
+        Client(MetricsRecorder &metrics_recorder, RateLimiter &rate_limiter);
         ~Client();
 
     public:
@@ -43,11 +46,16 @@ class WOINCUI_LOCAL Client {
 
         const std::string &host() const;
 
+        MetricsRecorder &metrics_recorder();
+
     private:
         bool connected_ = false;
 
         std::string host_;
 
+        MetricsRecorder &metrics_recorder_;
+        RateLimiter &rate_limiter_;
+
         woinc::rpc::Connection rpc_connection_;
 };
 
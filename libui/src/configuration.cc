@@ -20,60 +20,154 @@
 
 #include <algorithm>
 #include <cassert>
+#include <utility>
 
 #define WOINC_CONFIGURATION_LOCK_GUARD std::lock_guard<decltype(lock_)> guard(lock_)
 
+namespace {
+
+using namespace woinc::ui;
+
+void apply_overrides__(Configuration::Intervals &intervals, const Configuration::Intervals &overrides) {
+    for (size_t i = 0; i < intervals.size(); ++i)
+        if (overrides[i].count() > 0)
+            intervals[i] = overrides[i];
+}
+
+void update_intervals__(Configuration::Snapshot &snapshot) {
+    for (auto &host : snapshot.hosts) {
+        auto &host_configuration = host.second;
+
+        host_configuration.intervals = snapshot.intervals;
+
+        auto group = snapshot.group_intervals.find(host_configuration.group);
+        if (group != snapshot.group_intervals.end())
+            apply_overrides__(host_configuration.intervals, group->second);
+
+        apply_overrides__(host_configuration.intervals, host_configuration.interval_overrides);
+    }
+}
+
+}
+
 namespace woinc { namespace ui {
 
-void Configuration::interval(PeriodicTask task, int seconds) {
+// ---- Configuration::Snapshot ----
+
+const Configuration::HostConfiguration *Configuration::Snapshot::host(const std::string &host) const {
+    auto iter = hosts.find(host);
+    return iter == hosts.end() ? nullptr : &iter->second;
+}
+
+// ---- Configuration ----
+
+Configuration::Configuration() : snapshot_(std::make_shared<const Snapshot>()), version_(0) {}
+
+std::shared_ptr<const Configuration::Snapshot> Configuration::snapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+std::uint64_t Configuration::version() const {
+    return version_.load(std::memory_order_acquire);
+}
+
+template<typename MODIFY>
+void Configuration::modify_(MODIFY &&modify) {
     WOINC_CONFIGURATION_LOCK_GUARD;
-    intervals_[static_cast<size_t>(task)] = std::chrono::seconds(seconds);
+
+    auto snapshot = std::make_shared<Snapshot>(*std::atomic_load(&snapshot_));
+    modify(*snapshot);
+    update_intervals__(*snapshot);
+    ++snapshot->version;
+
+    const auto version = snapshot->version;
+    std::atomic_store(&snapshot_, std::shared_ptr<const Snapshot>(std::move(snapshot)));
+    version_.store(version, std::memory_order_release);
+}
+
+void Configuration::interval(PeriodicTask task, int seconds) {
+    modify_([&](Snapshot &snapshot) {
+        snapshot.intervals[static_cast<size_t>(task)] = std::chrono::seconds(seconds);
+    });
 }
 
 int Configuration::interval(PeriodicTask task) const {
-    WOINC_CONFIGURATION_LOCK_GUARD;
-    return static_cast<int>(intervals_.at(static_cast<size_t>(task)).count());
+    return static_cast<int>(snapshot()->intervals.at(static_cast<size_t>(task)).count());
 }
 
-Configuration::Intervals Configuration::intervals() const {
-    WOINC_CONFIGURATION_LOCK_GUARD;
-    return intervals_;
+void Configuration::interval(const std::string &host, PeriodicTask task, int seconds) {
+    modify_([&](Snapshot &snapshot) {
+        assert(snapshot.hosts.find(host) != snapshot.hosts.end());
+        snapshot.hosts.at(host).interval_overrides[static_cast<size_t>(task)] = std::chrono::seconds(seconds);
+    });
+}
+
+void Configuration::group_interval(const std::string &group, PeriodicTask task, int seconds) {
+    modify_([&](Snapshot &snapshot) {
+        auto &intervals = snapshot.group_intervals[group];
+        intervals[static_cast<size_t>(task)] = std::chrono::seconds(seconds);
+        if (std::all_of(intervals.cbegin(), intervals.cend(), [](const auto &i) { return i.count() == 0; }))
+            snapshot.group_intervals.erase(group);
+    });
+}
+
+void Configuration::group(const std::string &host, const std::string &group) {
+    modify_([&](Snapshot &snapshot) {
+        assert(snapshot.hosts.find(host) != snapshot.hosts.end());
+        snapshot.hosts.at(host).group = group;
+    });
+}
+
+std::string Configuration::group(const std::string &host) const {
+    auto snapshot = this->snapshot();
+    assert(snapshot->host(host) != nullptr);
+    return snapshot->hosts.at(host).group;
+}
+
+int Configuration::interval(const std::string &host, PeriodicTask task) const {
+    auto snapshot = this->snapshot();
+    assert(snapshot->host(host) != nullptr);
+    return static_cast<int>(snapshot->hosts.at(host).intervals.at(static_cast<size_t>(task)).count());
 }
 
 void Configuration::active_only_tasks(const std::string &host, bool value) {
-    WOINC_CONFIGURATION_LOCK_GUARD;
-    assert(host_configurations_.find(host) != host_configurations_.end());
-    host_configurations_.at(host).active_only_tasks_ = value;
+    modify_([&](Snapshot &snapshot) {
+        assert(snapshot.hosts.find(host) != snapshot.hosts.end());
+        snapshot.hosts.at(host).active_only_tasks = value;
+    });
 }
 
 bool Configuration::active_only_tasks(const std::string &host) const {
-    WOINC_CONFIGURATION_LOCK_GUARD;
-    assert(host_configurations_.find(host) != host_configurations_.end());
-    return host_configurations_.at(host).active_only_tasks_;
+    auto snapshot = this->snapshot();
+    assert(snapshot->host(host) != nullptr);
+    return snapshot->hosts.at(host).active_only_tasks;
 }
 
 void Configuration::schedule_periodic_tasks(const std::string &host, bool value) {
-    WOINC_CONFIGURATION_LOCK_GUARD;
-    assert(host_configurations_.find(host) != host_configurations_.end());
-    host_configurations_.at(host).schedule_periodic_tasks = value;
+    modify_([&](Snapshot &snapshot) {
+        assert(snapshot.hosts.find(host) != snapshot.hosts.end());
+        snapshot.hosts.at(host).schedule_periodic_tasks = value;
+    });
 }
 
 bool Configuration::schedule_periodic_tasks(const std::string &host) const {
-    WOINC_CONFIGURATION_LOCK_GUARD;
-    assert(host_configurations_.find(host) != host_configurations_.end());
-    return host_configurations_.at(host).schedule_periodic_tasks;
+    auto snapshot = this->snapshot();
+    assert(snapshot->host(host) != nullptr);
+    return snapshot->hosts.at(host).schedule_periodic_tasks;
 }
 
 void Configuration::add_host(const std::string &host) {
-    WOINC_CONFIGURATION_LOCK_GUARD;
-    assert(host_configurations_.find(host) == host_configurations_.end());
-    host_configurations_.emplace(host, HostConfiguration());
+    modify_([&](Snapshot &snapshot) {
+        assert(snapshot.hosts.find(host) == snapshot.hosts.end());
+        snapshot.hosts.emplace(host, HostConfiguration());
+    });
 }
 
 void Configuration::remove_host(const std::string &host) {
-    WOINC_CONFIGURATION_LOCK_GUARD;
-    assert(host_configurations_.find(host) != host_configurations_.end());
-    host_configurations_.erase(host);
+    modify_([&](Snapshot &snapshot) {
+        assert(snapshot.hosts.find(host) != snapshot.hosts.end());
+        snapshot.hosts.erase(host);
+    });
 }
 
 }}
@@ -20,8 +20,11 @@
 #define WOINC_UI_CONFIGURATION_H_
 
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 
@@ -31,15 +34,68 @@
 
 namespace woinc { namespace ui {
 
+// The configuration is published as immutable snapshots. Each modification copies the current
+// snapshot, modifies the copy and replaces the current snapshot atomically, so readers don't
+// need to lock. Modifications are rare, while the scheduler reads the configuration on each tick.
 class WOINCUI_LOCAL Configuration {
     public:
         typedef std::array<std::chrono::seconds, 9> Intervals;
 
+        struct HostConfiguration {
+            bool schedule_periodic_tasks = false;
+            bool active_only_tasks = false;
+            std::string group;
+            // the overrides of the host, zero means not overridden
+            Intervals interval_overrides = {};
+            // taken from the host, its group or the global intervals, in this order
+            Intervals intervals = {};
+        };
+
+        struct Snapshot {
+            std::uint64_t version = 0;
+
+            Intervals intervals = {
+                /* GET_CCSTATUS */          std::chrono::seconds(1),
+                /* GET_CLIENT_STATE */      std::chrono::seconds(3600),
+                /* GET_DISK_USAGE */        std::chrono::seconds(60),
+                /* GET_FILE_TRANSFERS */    std::chrono::seconds(1),
+                /* GET_MESSAGES */          std::chrono::seconds(1),
+                /* GET_NOTICES */           std::chrono::seconds(60),
+                /* GET_PROJECT_STATUS */    std::chrono::seconds(1),
+                /* GET_STATISTICS */        std::chrono::seconds(60),
+                /* GET_TASKS */             std::chrono::seconds(1)
+            };
+
+            // the overrides of the groups, zero means not overridden
+            std::map<std::string, Intervals> group_intervals;
+
+            std::map<std::string, HostConfiguration> hosts;
+
+            // returns nullptr for unknown hosts
+            const HostConfiguration *host(const std::string &host) const;
+        };
+
+    public:
+        Configuration();
+
+        // returns the current snapshot, which isn't changed by later modifications
+        std::shared_ptr<const Snapshot> snapshot() const;
+        // the version of the current snapshot, to check cheaply whether a snapshot is outdated
+        std::uint64_t version() const;
+
     public:
         void interval(PeriodicTask task, int seconds);
         int interval(PeriodicTask task) const;
 
-        Intervals intervals() const;
+        // An interval of 0 removes the override of the host or group.
+        void interval(const std::string &host, PeriodicTask task, int seconds);
+        void group_interval(const std::string &group, PeriodicTask task, int seconds);
+        // an empty group removes the host from its group
+        void group(const std::string &host, const std::string &group);
+        std::string group(const std::string &host) const;
+
+        // the effective interval
+        int interval(const std::string &host, PeriodicTask task) const;
 
         void active_only_tasks(const std::string &host, bool value);
         bool active_only_tasks(const std::string &host) const;
@@ -52,27 +108,17 @@ class WOINCUI_LOCAL Configuration {
         void add_host(const std::string &host);
         void remove_host(const std::string &host);
 
-    private:
-        mutable std::mutex lock_;
-
-        Intervals intervals_ = {
-            /* GET_CCSTATUS */          std::chrono::seconds(1),
-            /* GET_CLIENT_STATE */      std::chrono::seconds(3600),
-            /* GET_DISK_USAGE */        std::chrono::seconds(60),
-            /* GET_FILE_TRANSFERS */    std::chrono::seconds(1),
-            /* GET_MESSAGES */          std::chrono::seconds(1),
-            /* GET_NOTICES */           std::chrono::seconds(60),
-            /* GET_PROJECT_STATUS */    std::chrono::seconds(1),
-            /* GET_STATISTICS */        std::chrono::seconds(60),
-            /* GET_TASKS */             std::chrono::seconds(1)
-        };
+        // publishes a modified copy of the current snapshot
+        template<typename MODIFY>
+        void modify_(MODIFY &&modify);
 
-        struct HostConfiguration {
-            bool schedule_periodic_tasks = false;
-            bool active_only_tasks_ = false;
-        };
+    private:
+        // serializes the modifications only
+        std::mutex lock_;
 
-        std::map<std::string, HostConfiguration> host_configurations_;
+        // accessed via std::atomic_load and std::atomic_store only
+        std::shared_ptr<const Snapshot> snapshot_;
+        std::atomic<std::uint64_t> version_;
 };
 
 }}
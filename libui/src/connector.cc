@@ -0,0 +1,120 @@
+/* libui/src/connector.cc --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+#include "connector.h"
+
+#include <cassert>
+#include <utility>
+
+#include <woinc/trace.h>
+
+#define WOINC_LOCK_GUARD std::lock_guard<decltype(lock_)> guard(lock_)
+
+namespace woinc { namespace ui {
+
+Connector::Connector(std::size_t max_threads) : max_threads_(max_threads) {
+    assert(max_threads_ > 0);
+}
+
+Connector::~Connector() {
+    shutdown();
+}
+
+bool Connector::submit(std::function<void()> task, std::function<void()> cancel) {
+    WOINC_LOCK_GUARD;
+
+    if (shutdown_)
+        return false;
+
+    tasks_.push_back({std::move(task), std::move(cancel)});
+
+    if (idle_threads_ == 0 && running_threads_ < max_threads_) {
+        ++running_threads_;
+        threads_.emplace_back(&Connector::work_, this);
+    } else {
+        condition_.notify_one();
+    }
+
+    return true;
+}
+
+void Connector::max_threads(std::size_t max_threads) {
+    assert(max_threads > 0);
+
+    WOINC_LOCK_GUARD;
+    max_threads_ = max_threads;
+    // wake up idle threads to let the surplus ones exit
+    condition_.notify_all();
+}
+
+std::size_t Connector::max_threads() const {
+    WOINC_LOCK_GUARD;
+    return max_threads_;
+}
+
+void Connector::shutdown() {
+    std::deque<Task> cancelled;
+    std::vector<std::thread> threads;
+
+    {
+        WOINC_LOCK_GUARD;
+        shutdown_ = true;
+        cancelled.swap(tasks_);
+        threads.swap(threads_);
+    }
+
+    condition_.notify_all();
+
+    // the tasks may call into the controller, so they are cancelled and the threads are joined without being locked
+    for (auto &task : cancelled)
+        if (task.cancel)
+            task.cancel();
+
+    for (auto &thread : threads)
+        if (thread.joinable())
+            thread.join();
+}
+
+void Connector::work_() {
+    woinc::trace::thread_name("connector");
+
+    std::unique_lock<decltype(lock_)> guard(lock_);
+
+    while (true) {
+        ++idle_threads_;
+        condition_.wait(guard, [this]() {
+            return shutdown_ || !tasks_.empty() || running_threads_ > max_threads_;
+        });
+        --idle_threads_;
+
+        if (shutdown_ || running_threads_ > max_threads_)
+            break;
+
+        auto task = std::move(tasks_.front().run);
+        tasks_.pop_front();
+
+        guard.unlock();
+        task();
+        guard.lock();
+    }
+
+    // exited threads are joined on shutdown
+    --running_threads_;
+}
+
+}}
@@ -0,0 +1,82 @@
+/* libui/src/connector.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef WOINC_UI_CONNECTOR_H_
+#define WOINC_UI_CONNECTOR_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "visibility.h"
+
+namespace woinc { namespace ui {
+
+// Executes the connects to the hosts, which may block for a long time (see man 2 connect),
+// with a bounded number of threads. The threads are started on demand and reused afterwards,
+// so adding many hosts at once doesn't create a thread per host.
+class WOINCUI_LOCAL Connector {
+    public:
+        explicit Connector(std::size_t max_threads);
+        ~Connector();
+
+        Connector(const Connector &) = delete;
+        Connector &operator=(const Connector &) = delete;
+
+        Connector(Connector &&) = delete;
+        Connector &operator=(Connector &&) = delete;
+
+        // returns false if the connector is shut down, the task isn't executed in this case;
+        // the optional cancel function is called instead of the task if the task is still pending on shutdown
+        bool submit(std::function<void()> task, std::function<void()> cancel = std::function<void()>());
+
+        // surplus threads exit after finishing their current task
+        void max_threads(std::size_t max_threads);
+        std::size_t max_threads() const;
+
+        // cancels the pending tasks and waits for the running ones
+        void shutdown();
+
+    private:
+        void work_();
+
+    private:
+        mutable std::mutex lock_;
+        std::condition_variable condition_;
+
+        struct Task {
+            std::function<void()> run;
+            std::function<void()> cancel;
+        };
+
+        std::deque<Task> tasks_;
+        std::vector<std::thread> threads_;
+
+        std::size_t max_threads_;
+        std::size_t running_threads_ = 0;
+        std::size_t idle_threads_ = 0;
+        bool shutdown_ = false;
+};
+
+}}
+
+#endif
@@ -19,17 +19,21 @@
 #include <woinc/ui/controller.h>
 
 #include <cassert>
+#include <chrono>
 #include <exception>
+#include <functional>
 #include <map>
 #include <mutex>
 #include <stdexcept>
 #include <thread>
+#include <vector>
 
 #ifndef NDEBUG
 #include <iostream>
 #endif
 
 #include "configuration.h"
+#include "connector.h"
 #include "handler_registry.h"
 #include "host_controller.h"
 #include "periodic_tasks_scheduler.h"
@@ -49,6 +53,35 @@ void check_not_empty_host_name__(const std::string &host) {
     check_not_empty__(host, "Missing host name");
 }
 
+// ---- extracting the results of the commands ----
+
+template<typename COMMAND>
+bool success__(wrpc::Command &cmd) {
+    return static_cast<COMMAND &>(cmd).response().success;
+}
+
+woinc::GlobalPreferences preferences__(wrpc::Command &cmd) {
+    return static_cast<wrpc::GetGlobalPreferencesCommand &>(cmd).response().preferences;
+}
+
+// ---- passing the results of the commands to the user ----
+
+template<typename RESULT, typename SCHEDULE>
+std::future<RESULT> promised__(SCHEDULE &&schedule) {
+    woinc::ui::PromiseSink<RESULT> sink;
+    auto future = sink.promise.get_future();
+    schedule(std::move(sink));
+    return future;
+}
+
+template<typename RESULT>
+woinc::ui::CompletionSink<RESULT> completion_sink__(woinc::ui::Completion<RESULT> completion,
+                                                   woinc::ui::Executor executor) {
+    if (!completion)
+        throw std::invalid_argument("Missing completion");
+    return woinc::ui::CompletionSink<RESULT>(std::move(completion), std::move(executor));
+}
+
 }
 
 namespace woinc { namespace ui {
@@ -74,9 +107,19 @@ class WOINCUI_LOCAL Controller::Impl {
         void register_handler(PeriodicTaskHandler *handler);
         void deregister_handler(PeriodicTaskHandler *handler);
 
+        void register_handler(DeltaHandler *handler);
+        void deregister_handler(DeltaHandler *handler);
+
+        void register_handler(MetricsHandler *handler);
+        void deregister_handler(MetricsHandler *handler);
+
         void add_host(std::string host,
                       std::string url,
                       std::uint16_t port);
+        template<typename SINK>
+        void add_hosts(std::vector<HostTarget> targets, BulkProgress progress, Executor executor, SINK sink);
+        void max_concurrent_connects(std::size_t max_connects);
+        std::size_t max_concurrent_connects() const;
         void authorize_host(std::string host,
                             std::string password);
 
@@ -85,25 +128,63 @@ class WOINCUI_LOCAL Controller::Impl {
 
         void periodic_task_interval(const PeriodicTask task, int interval);
         int periodic_task_interval(const PeriodicTask task) const;
+        void periodic_task_interval(const std::string &host, PeriodicTask task, int interval);
+        void group_periodic_task_interval(const std::string &group, PeriodicTask task, int interval);
+        int periodic_task_interval(const std::string &host, PeriodicTask task) const;
+        void host_group(const std::string &host, const std::string &group);
+        std::string host_group(const std::string &host) const;
         void schedule_periodic_tasks(const std::string &host, bool value);
         void reschedule_now(const std::string &host, PeriodicTask task);
 
         void active_only_tasks(const std::string &host, bool value);
 
-        std::future<bool> file_transfer_op(const std::string &host, FILE_TRANSFER_OP op,
-                                           const std::string &master_url, const std::string &filename);
-        std::future<bool> project_op(const std::string &host, PROJECT_OP op, const std::string &master_url);
-        std::future<bool> task_op(const std::string &host, TASK_OP op, const std::string &master_url, const std::string &task_name);
-
-        std::future<GlobalPreferences> load_global_preferences(const std::string &host, GET_GLOBAL_PREFS_MODE mode);
-        std::future<bool> save_global_preferences(const std::string &host, const GlobalPreferences &prefs, const GlobalPreferencesMask &mask);
-        std::future<bool> read_global_prefs_override(const std::string &host);
-
-        std::future<bool> run_mode(const std::string &host, RUN_MODE mode);
-        std::future<bool> gpu_mode(const std::string &host, RUN_MODE mode);
-        std::future<bool> network_mode(const std::string &host, RUN_MODE mode);
+        void subscribe(const PeriodicTaskHandler *handler, const std::string &host,
+                       PeriodicTask task, int max_staleness);
+        void unsubscribe(const PeriodicTaskHandler *handler, const std::string &host, PeriodicTask task);
+        void unsubscribe(const PeriodicTaskHandler *handler, const std::string &host);
+
+        HostState snapshot(const std::string &host);
+        std::uint64_t version(const std::string &host, Entity entity);
+
+        Metrics metrics();
+
+        void job_queue_capacity(const std::string &host, std::size_t capacity, QueueOverflowPolicy policy);
+        void job_staleness_limit(const std::string &host, int seconds);
+        void rate_limit(const std::string &host, RateLimit limit);
+        RateLimit rate_limit(const std::string &host) const;
+
+        // the result of the commands is passed to the sink, see PromiseSink and CompletionSink
+
+        template<typename SINK>
+        void file_transfer_op(const std::string &host, FILE_TRANSFER_OP op,
+                              const std::string &master_url, const std::string &filename, SINK sink);
+        template<typename SINK>
+        void project_op(const std::string &host, PROJECT_OP op, const std::string &master_url, SINK sink);
+        template<typename SINK>
+        void task_op(const std::string &host, TASK_OP op, const std::string &master_url, const std::string &task_name, SINK sink);
+
+        template<typename SINK>
+        void load_global_preferences(const std::string &host, GET_GLOBAL_PREFS_MODE mode, SINK sink);
+        template<typename SINK>
+        void save_global_preferences(const std::string &host, const GlobalPreferences &prefs, const GlobalPreferencesMask &mask, SINK sink);
+        template<typename SINK>
+        void read_global_prefs_override(const std::string &host, SINK sink);
+
+        template<typename SINK>
+        void run_mode(const std::string &host, RUN_MODE mode, SINK sink);
+        template<typename SINK>
+        void gpu_mode(const std::string &host, RUN_MODE mode, SINK sink);
+        template<typename SINK>
+        void network_mode(const std::string &host, RUN_MODE mode, SINK sink);
+
+        template<typename SINK>
+        void bulk_task_op(TASK_OP op, std::vector<TaskTarget> targets, BulkProgress progress, Executor executor,
+                          std::size_t max_targets_per_job, SINK sink);
 
     private: // helper methods which assume the controller is already locked
+        // throws if the host is already registered, the host isn't connected yet
+        std::shared_ptr<HostController> add_host_(const std::string &host);
+
         // use a copy of the host string as it may be the key of the host controller map
         // which will be deleted in the erase call leading to a use after free access later on
         void remove_host_(std::string host);
@@ -111,13 +192,23 @@ class WOINCUI_LOCAL Controller::Impl {
 
         bool has_host_(const std::string &name) const;
 
-        void schedule_now_(const std::string &host, Job *job, const char *func);
-
         void verify_not_shutdown_() const;
         void verify_known_host_(const std::string &host, const char *func) const;
 
+    private: // helper methods locking the controller themselves
+        // connects asynchronously using the connector, the callback is called after the handlers were notified;
+        // if the controller is shut down before the connect started, the cancelled function is called instead;
+        // returns false if the controller is shut down
+        bool connect_(std::string host, std::shared_ptr<HostController> host_controller,
+                      std::string url, std::uint16_t port, std::function<void(bool connected)> callback,
+                      std::function<void()> cancelled);
+
+        // the job queue may block while pushing the job, therefore the controller isn't locked while doing so
+        void schedule_now_(const std::string &host, Job *job, const char *func);
+        void schedule_now_(const std::string &host, Job *job, PeriodicTask to_reschedule, const char *func);
+
     private:
-        std::mutex lock_;
+        mutable std::mutex lock_;
 
         bool shutdown_ = false;
 
@@ -128,13 +219,17 @@ class WOINCUI_LOCAL Controller::Impl {
         PeriodicTasksSchedulerContext periodic_tasks_scheduler_context_;
         std::thread periodic_tasks_scheduler_thread_;
 
-        typedef std::map<std::string, std::unique_ptr<HostController>> HostControllers;
+        // shared to be able to schedule jobs without locking the controller
+        typedef std::map<std::string, std::shared_ptr<HostController>> HostControllers;
         HostControllers host_controllers_;
+
+        Connector connector_;
 };
 
 Controller::Impl::Impl() :
     periodic_tasks_scheduler_context_(configuration_, handler_registry_),
-    periodic_tasks_scheduler_thread_(PeriodicTasksScheduler(periodic_tasks_scheduler_context_))
+    periodic_tasks_scheduler_thread_(PeriodicTasksScheduler(periodic_tasks_scheduler_context_)),
+    connector_(16)
 {}
 
 Controller::Impl::~Impl() {
@@ -142,11 +237,19 @@ Controller::Impl::~Impl() {
 }
 
 void Controller::Impl::shutdown() {
-    WOINC_LOCK_GUARD;
-
     // shutdown the controller
 
-    shutdown_ = true;
+    {
+        WOINC_LOCK_GUARD;
+        shutdown_ = true;
+    }
+
+    // shutdown the connector; the running connects notify the handlers, which may call
+    // the controller, therefore the connector is shut down without being locked
+
+    connector_.shutdown();
+
+    WOINC_LOCK_GUARD;
 
     // shutdown the periodic tasks scheduler
 
@@ -175,6 +278,23 @@ void Controller::Impl::register_handler(PeriodicTaskHandler *handler) {
 
 void Controller::Impl::deregister_handler(PeriodicTaskHandler *handler) {
     handler_registry_.deregister_handler(handler);
+    periodic_tasks_scheduler_context_.unsubscribe(handler);
+}
+
+void Controller::Impl::register_handler(DeltaHandler *handler) {
+    handler_registry_.register_handler(handler);
+}
+
+void Controller::Impl::deregister_handler(DeltaHandler *handler) {
+    handler_registry_.deregister_handler(handler);
+}
+
+void Controller::Impl::register_handler(MetricsHandler *handler) {
+    handler_registry_.register_handler(handler);
+}
+
+void Controller::Impl::deregister_handler(MetricsHandler *handler) {
+    handler_registry_.deregister_handler(handler);
 }
 
 void Controller::Impl::add_host(std::string host,
@@ -183,38 +303,114 @@ void Controller::Impl::add_host(std::string host,
     check_not_empty_host_name__(host);
     check_not_empty__(url, "Missing url to host");
 
-    HostController *host_controller = nullptr;
+    std::shared_ptr<HostController> host_controller;
 
     {
         WOINC_LOCK_GUARD;
+        verify_not_shutdown_();
+        host_controller = add_host_(host);
+    }
 
+    connect_(std::move(host), std::move(host_controller), std::move(url), port, nullptr, nullptr);
+}
+
+template<typename SINK>
+void Controller::Impl::add_hosts(std::vector<HostTarget> targets, BulkProgress progress, Executor executor, SINK sink) {
+    for (const auto &target : targets) {
+        check_not_empty_host_name__(target.host);
+        check_not_empty__(target.url, "Missing url to host");
+    }
+
+    {
+        WOINC_LOCK_GUARD;
         verify_not_shutdown_();
+    }
 
-        if (has_host_(host))
-            throw std::invalid_argument("Host \"" + host + "\" already registered.");
+    if (targets.empty()) {
+        sink.set_value(AddHostsResult());
+        return;
+    }
 
-        host_controller = new HostController(host);
+    const auto count = targets.size();
+    auto operation = std::make_shared<BulkOperation<HostTarget, SINK>>(
+        std::move(targets), std::move(sink), std::move(progress), std::move(executor));
 
-        configuration_.add_host(host);
-        host_controllers_.emplace(host, std::move(host_controller));
-        // periodic tasks are not scheduled yet
-        periodic_tasks_scheduler_context_.add_host(host, *host_controllers_.at(host));
+    // register all hosts at once, a failing host (e.g. an already registered one) doesn't fail the others
+    std::vector<std::shared_ptr<HostController>> host_controllers(count);
+    std::vector<std::string> errors(count);
+    {
+        WOINC_LOCK_GUARD;
 
-        handler_registry_.for_host_handler([&](auto &handler) {
-            handler.on_host_added(host);
-        });
+        // the controller may have been shut down since the check above
+        for (std::size_t index = 0; index < count; ++index) {
+            if (shutdown_) {
+                errors[index] = "The controller is shut down";
+                continue;
+            }
+            try {
+                host_controllers[index] = add_host_(operation->target(index).host);
+            } catch (const std::invalid_argument &e) {
+                errors[index] = e.what();
+            }
+        }
     }
 
-    // connect asynchronously because the connect may block for a long time (see man 2 connect)
-    std::thread([=]() {
-        bool connected = host_controller->connect(url, port);
-        handler_registry_.for_host_handler([&](HostHandler &handler) {
-            if (connected)
-                handler.on_host_connected(host);
-            else
-                handler.on_host_error(host, Error::CONNECTION_ERROR);
-        });
-    }).detach();
+    for (std::size_t index = 0; index < count; ++index) {
+        // the progress and the sink are user code, so the failed hosts are finished without being locked
+        if (!host_controllers[index]) {
+            operation->finish(index, false, std::move(errors[index]));
+            continue;
+        }
+
+        const auto &host_target = operation->target(index);
+
+        auto callback = [this, operation, index](bool connected) {
+            const auto &target = operation->target(index);
+
+            if (!connected) {
+                operation->finish(index, false, "Could not connect to host \"" + target.host + "\"");
+                return;
+            }
+
+            if (target.password.empty()) {
+                operation->finish(index, true);
+                return;
+            }
+
+            auto job = new AuthorizationJob(target.password, handler_registry_,
+                                            [operation, index](bool authorized, std::string error) {
+                operation->finish(index, authorized, std::move(error));
+            });
+
+            try {
+                schedule_now_(target.host, job, __func__);
+            } catch (const ShutdownException &) {
+                operation->finish(index, false, "The controller is shut down");
+            } catch (const UnknownHostException &) {
+                operation->finish(index, false, "The host \"" + target.host + "\" has been removed");
+            } catch (const QueueFullException &) {
+                operation->finish(index, false, "The job queue of host \"" + target.host + "\" is full");
+            }
+        };
+
+        auto cancelled = [operation, index]() {
+            operation->finish(index, false, "The controller is shut down");
+        };
+
+        if (!connect_(host_target.host, std::move(host_controllers[index]), host_target.url, host_target.port,
+                      std::move(callback), std::move(cancelled)))
+            operation->finish(index, false, "The controller is shut down");
+    }
+}
+
+void Controller::Impl::max_concurrent_connects(std::size_t max_connects) {
+    if (max_connects == 0)
+        throw std::invalid_argument("Invalid number of concurrent connects");
+    connector_.max_threads(max_connects);
+}
+
+std::size_t Controller::Impl::max_concurrent_connects() const {
+    return connector_.max_threads();
 }
 
 void Controller::Impl::authorize_host(std::string host,
@@ -222,14 +418,7 @@ void Controller::Impl::authorize_host(std::string host,
     check_not_empty_host_name__(host);
     check_not_empty__(password, "Missing password");
 
-    WOINC_LOCK_GUARD;
-
-    verify_not_shutdown_();
-    verify_known_host_(host, __func__);
-
-    auto hc = host_controllers_.find(host);
-    assert(hc != host_controllers_.end());
-    hc->second->authorize(password, handler_registry_);
+    schedule_now_(host, new AuthorizationJob(password, handler_registry_), __func__);
 }
 
 void Controller::Impl::remove_host(const std::string &host) {
@@ -255,6 +444,60 @@ int Controller::Impl::periodic_task_interval(const PeriodicTask task) const {
     return configuration_.interval(task);
 }
 
+void Controller::Impl::periodic_task_interval(const std::string &host, PeriodicTask task, int interval) {
+    check_not_empty_host_name__(host);
+    if (interval < 0)
+        throw std::invalid_argument("Negative interval");
+
+    WOINC_LOCK_GUARD;
+
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
+
+    configuration_.interval(host, task, interval);
+}
+
+void Controller::Impl::group_periodic_task_interval(const std::string &group, PeriodicTask task, int interval) {
+    check_not_empty__(group, "Missing group name");
+    if (interval < 0)
+        throw std::invalid_argument("Negative interval");
+
+    configuration_.group_interval(group, task, interval);
+}
+
+int Controller::Impl::periodic_task_interval(const std::string &host, PeriodicTask task) const {
+    check_not_empty_host_name__(host);
+
+    WOINC_LOCK_GUARD;
+
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
+
+    return configuration_.interval(host, task);
+}
+
+void Controller::Impl::host_group(const std::string &host, const std::string &group) {
+    check_not_empty_host_name__(host);
+
+    WOINC_LOCK_GUARD;
+
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
+
+    configuration_.group(host, group);
+}
+
+std::string Controller::Impl::host_group(const std::string &host) const {
+    check_not_empty_host_name__(host);
+
+    WOINC_LOCK_GUARD;
+
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
+
+    return configuration_.group(host);
+}
+
 void Controller::Impl::schedule_periodic_tasks(const std::string &host, bool value) {
     check_not_empty_host_name__(host);
 
@@ -289,231 +532,330 @@ void Controller::Impl::active_only_tasks(const std::string &host, bool value) {
     periodic_tasks_scheduler_context_.reschedule_now(host, PeriodicTask::GET_TASKS);
 }
 
-std::future<bool> Controller::Impl::file_transfer_op(const std::string &host, FILE_TRANSFER_OP op,
-                                        const std::string &master_url, const std::string &filename) {
+void Controller::Impl::subscribe(const PeriodicTaskHandler *handler, const std::string &host,
+                                 PeriodicTask task, int max_staleness) {
     check_not_empty_host_name__(host);
-    check_not_empty__(master_url, "Missing master url");
-    check_not_empty__(filename, "Missing filename");
+    if (handler == nullptr)
+        throw std::invalid_argument("Missing handler");
+    if (max_staleness < 0)
+        throw std::invalid_argument("Negative max staleness");
 
-    std::promise<bool> promise;
-    auto future = promise.get_future();
+    WOINC_LOCK_GUARD;
 
-    auto job = new PromisedResultJob<bool>(
-        new wrpc::FileTransferOpCommand(wrpc::FileTransferOpRequest(op, master_url, filename)),
-        std::move(promise),
-        [](wrpc::Command *c, std::promise<bool> &p, wrpc::COMMAND_STATUS status) {
-            if (status == wrpc::COMMAND_STATUS::OK)
-                p.set_value(static_cast<wrpc::FileTransferOpCommand *>(c)->response().success);
-            else
-                p.set_exception(std::make_exception_ptr(std::runtime_error("Error while executing file transfer operation")));
-        });
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
 
-    {
-        WOINC_LOCK_GUARD;
-        schedule_now_(host, job, __func__);
-        periodic_tasks_scheduler_context_.reschedule_now(host, PeriodicTask::GET_FILE_TRANSFERS);
-    }
+    periodic_tasks_scheduler_context_.subscribe(handler, host, task, std::chrono::seconds(max_staleness));
+}
 
-    return future;
+void Controller::Impl::unsubscribe(const PeriodicTaskHandler *handler, const std::string &host, PeriodicTask task) {
+    check_not_empty_host_name__(host);
+
+    WOINC_LOCK_GUARD;
+
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
+
+    periodic_tasks_scheduler_context_.unsubscribe(handler, host, task);
 }
 
-std::future<bool> Controller::Impl::project_op(const std::string &host, PROJECT_OP op, const std::string &master_url) {
+void Controller::Impl::unsubscribe(const PeriodicTaskHandler *handler, const std::string &host) {
     check_not_empty_host_name__(host);
-    check_not_empty__(master_url, "Missing master url");
 
-    std::promise<bool> promise;
-    auto future = promise.get_future();
+    WOINC_LOCK_GUARD;
 
-    auto job = new PromisedResultJob<bool>(
-        new wrpc::ProjectOpCommand(wrpc::ProjectOpRequest(op, master_url)),
-        std::move(promise),
-        [](wrpc::Command *c, std::promise<bool> &p, wrpc::COMMAND_STATUS status) {
-            if (status == wrpc::COMMAND_STATUS::OK)
-                p.set_value(static_cast<wrpc::ProjectOpCommand *>(c)->response().success);
-            else
-                p.set_exception(std::make_exception_ptr(std::runtime_error("Error while executing project operation")));
-        });
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
 
-    {
-        WOINC_LOCK_GUARD;
-        schedule_now_(host, job, __func__);
-        periodic_tasks_scheduler_context_.reschedule_now(host, PeriodicTask::GET_PROJECT_STATUS);
-    }
+    periodic_tasks_scheduler_context_.unsubscribe(handler, host);
+}
 
-    return future;
+HostState Controller::Impl::snapshot(const std::string &host) {
+    check_not_empty_host_name__(host);
+
+    WOINC_LOCK_GUARD;
+
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
+
+    return host_controllers_.at(host)->state_cache().snapshot();
 }
 
-std::future<bool> Controller::Impl::task_op(const std::string &host, TASK_OP op,
-                               const std::string &master_url, const std::string &task_name) {
+std::uint64_t Controller::Impl::version(const std::string &host, Entity entity) {
     check_not_empty_host_name__(host);
-    check_not_empty__(master_url, "Missing master url");
-    check_not_empty__(task_name, "Missing task name");
 
-    std::promise<bool> promise;
-    auto future = promise.get_future();
+    WOINC_LOCK_GUARD;
 
-    auto job = new PromisedResultJob<bool>(
-        new wrpc::TaskOpCommand(wrpc::TaskOpRequest(op, master_url, task_name)),
-        std::move(promise),
-        [](wrpc::Command *c, std::promise<bool> &p, wrpc::COMMAND_STATUS status) {
-            if (status == wrpc::COMMAND_STATUS::OK)
-                p.set_value(static_cast<wrpc::TaskOpCommand *>(c)->response().success);
-            else
-                p.set_exception(std::make_exception_ptr(std::runtime_error("Error while executing task operation")));
-        });
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
 
-    {
-        WOINC_LOCK_GUARD;
-        schedule_now_(host, job, __func__);
-        periodic_tasks_scheduler_context_.reschedule_now(host, PeriodicTask::GET_TASKS);
-    }
+    return host_controllers_.at(host)->state_cache().version(entity);
+}
 
-    return future;
+Metrics Controller::Impl::metrics() {
+    WOINC_LOCK_GUARD;
+
+    verify_not_shutdown_();
+
+    Metrics metrics;
+    for (const auto &hc : host_controllers_)
+        metrics.emplace(hc.first, hc.second->metrics());
+    return metrics;
 }
 
-std::future<GlobalPreferences> Controller::Impl::load_global_preferences(const std::string &host, GET_GLOBAL_PREFS_MODE mode) {
+void Controller::Impl::job_queue_capacity(const std::string &host, std::size_t capacity, QueueOverflowPolicy policy) {
     check_not_empty_host_name__(host);
 
-    std::promise<GlobalPreferences> promise;
-    auto future = promise.get_future();
+    WOINC_LOCK_GUARD;
 
-    auto job = new PromisedResultJob<woinc::GlobalPreferences>(
-        new wrpc::GetGlobalPreferencesCommand(wrpc::GetGlobalPreferencesRequest{ mode }),
-        std::move(promise),
-        [](wrpc::Command *c, std::promise<woinc::GlobalPreferences> &p, wrpc::COMMAND_STATUS status) {
-            if (status == wrpc::COMMAND_STATUS::OK) {
-                p.set_value(static_cast<wrpc::GetGlobalPreferencesCommand *>(c)->response().preferences);
-            } else {
-                p.set_exception(std::make_exception_ptr(std::runtime_error("Error while loading the preferences")));
-            }
-        });
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
 
-    {
-        WOINC_LOCK_GUARD;
-        schedule_now_(host, job, __func__);
-    }
+    host_controllers_.at(host)->job_queue_capacity(capacity, policy);
+}
 
-    return future;
+void Controller::Impl::job_staleness_limit(const std::string &host, int seconds) {
+    check_not_empty_host_name__(host);
+    if (seconds < 0)
+        throw std::invalid_argument("Negative staleness limit");
+
+    WOINC_LOCK_GUARD;
+
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
+
+    host_controllers_.at(host)->job_staleness_limit(std::chrono::seconds(seconds));
 }
 
-std::future<bool> Controller::Impl::save_global_preferences(const std::string &host, const GlobalPreferences &prefs, const GlobalPreferencesMask &mask) {
+void Controller::Impl::rate_limit(const std::string &host, RateLimit limit) {
     check_not_empty_host_name__(host);
+    if (limit.requests_per_second < 0)
+        throw std::invalid_argument("Negative rate limit");
+    if (limit.burst == 0)
+        throw std::invalid_argument("Invalid burst of the rate limit");
 
-    std::promise<bool> promise;
-    auto future = promise.get_future();
+    WOINC_LOCK_GUARD;
 
-    auto job = new PromisedResultJob<bool>(
-        new wrpc::SetGlobalPreferencesCommand(wrpc::SetGlobalPreferencesRequest{ prefs, mask }),
-        std::move(promise),
-        [](wrpc::Command *c, std::promise<bool> &p, wrpc::COMMAND_STATUS status) {
-            if (status == wrpc::COMMAND_STATUS::OK)
-                p.set_value(static_cast<wrpc::SetGlobalPreferencesCommand *>(c)->response().success);
-            else
-                p.set_exception(std::make_exception_ptr(std::runtime_error("Error while setting the preferences")));
-        });
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
 
-    {
-        WOINC_LOCK_GUARD;
-        schedule_now_(host, job, __func__);
-    }
+    host_controllers_.at(host)->rate_limit(limit);
+}
 
-    return future;
+RateLimit Controller::Impl::rate_limit(const std::string &host) const {
+    check_not_empty_host_name__(host);
+
+    WOINC_LOCK_GUARD;
+
+    verify_not_shutdown_();
+    verify_known_host_(host, __func__);
+
+    return host_controllers_.at(host)->rate_limit();
 }
 
-std::future<bool> Controller::Impl::read_global_prefs_override(const std::string &host) {
+template<typename SINK>
+void Controller::Impl::file_transfer_op(const std::string &host, FILE_TRANSFER_OP op,
+                                        const std::string &master_url, const std::string &filename,
+                                        SINK sink) {
     check_not_empty_host_name__(host);
+    check_not_empty__(master_url, "Missing master url");
+    check_not_empty__(filename, "Missing filename");
 
-    std::promise<bool> promise;
-    auto future = promise.get_future();
+    auto job = new CommandJob<bool, SINK>(
+        new wrpc::FileTransferOpCommand(wrpc::FileTransferOpRequest(op, master_url, filename)),
+        success__<wrpc::FileTransferOpCommand>,
+        "Error while executing file transfer operation",
+        std::move(sink));
 
-    auto job = new PromisedResultJob<bool>(
-        new wrpc::ReadGlobalPreferencesOverrideCommand,
-        std::move(promise),
-        [](wrpc::Command *c, std::promise<bool> &p, wrpc::COMMAND_STATUS status) {
-            if (status == wrpc::COMMAND_STATUS::OK)
-                p.set_value(static_cast<wrpc::ReadGlobalPreferencesOverrideCommand *>(c)->response().success);
-            else
-                p.set_exception(std::make_exception_ptr(std::runtime_error("Error reading the preferences")));
-        });
+    schedule_now_(host, job, PeriodicTask::GET_FILE_TRANSFERS, __func__);
+}
 
-    {
-        WOINC_LOCK_GUARD;
-        schedule_now_(host, job, __func__);
-    }
+template<typename SINK>
+void Controller::Impl::project_op(const std::string &host, PROJECT_OP op, const std::string &master_url,
+                                  SINK sink) {
+    check_not_empty_host_name__(host);
+    check_not_empty__(master_url, "Missing master url");
 
-    return future;
+    auto job = new CommandJob<bool, SINK>(
+        new wrpc::ProjectOpCommand(wrpc::ProjectOpRequest(op, master_url)),
+        success__<wrpc::ProjectOpCommand>,
+        "Error while executing project operation",
+        std::move(sink));
+
+    schedule_now_(host, job, PeriodicTask::GET_PROJECT_STATUS, __func__);
 }
 
-std::future<bool> Controller::Impl::run_mode(const std::string &host, RUN_MODE mode) {
+template<typename SINK>
+void Controller::Impl::task_op(const std::string &host, TASK_OP op,
+                               const std::string &master_url, const std::string &task_name,
+                               SINK sink) {
     check_not_empty_host_name__(host);
+    check_not_empty__(master_url, "Missing master url");
+    check_not_empty__(task_name, "Missing task name");
 
-    std::promise<bool> promise;
-    auto future = promise.get_future();
+    auto job = new CommandJob<bool, SINK>(
+        new wrpc::TaskOpCommand(wrpc::TaskOpRequest(op, master_url, task_name)),
+        success__<wrpc::TaskOpCommand>,
+        "Error while executing task operation",
+        std::move(sink));
 
-    auto job = new PromisedResultJob<bool>(
-        new wrpc::SetRunModeCommand(wrpc::SetRunModeRequest{mode}),
-        std::move(promise),
-        [](wrpc::Command *c, std::promise<bool> &p, wrpc::COMMAND_STATUS status) {
-            if (status == wrpc::COMMAND_STATUS::OK)
-                p.set_value(static_cast<wrpc::SetRunModeCommand *>(c)->response().success);
-            else
-                p.set_exception(std::make_exception_ptr(std::runtime_error("Error setting the run mode")));
-        });
+    schedule_now_(host, job, PeriodicTask::GET_TASKS, __func__);
+}
 
-    {
-        WOINC_LOCK_GUARD;
-        schedule_now_(host, job, __func__);
-    }
+template<typename SINK>
+void Controller::Impl::load_global_preferences(const std::string &host, GET_GLOBAL_PREFS_MODE mode, SINK sink) {
+    check_not_empty_host_name__(host);
 
-    return future;
+    auto job = new CommandJob<woinc::GlobalPreferences, SINK>(
+        new wrpc::GetGlobalPreferencesCommand(wrpc::GetGlobalPreferencesRequest{ mode }),
+        preferences__,
+        "Error while loading the preferences",
+        std::move(sink));
+
+    schedule_now_(host, job, __func__);
 }
 
-std::future<bool> Controller::Impl::gpu_mode(const std::string &host, RUN_MODE mode) {
+template<typename SINK>
+void Controller::Impl::save_global_preferences(const std::string &host, const GlobalPreferences &prefs,
+                                               const GlobalPreferencesMask &mask, SINK sink) {
     check_not_empty_host_name__(host);
 
-    std::promise<bool> promise;
-    auto future = promise.get_future();
+    auto job = new CommandJob<bool, SINK>(
+        new wrpc::SetGlobalPreferencesCommand(wrpc::SetGlobalPreferencesRequest{ prefs, mask }),
+        success__<wrpc::SetGlobalPreferencesCommand>,
+        "Error while setting the preferences",
+        std::move(sink));
 
-    auto job = new PromisedResultJob<bool>(
-        new wrpc::SetGpuModeCommand(wrpc::SetGpuModeRequest{mode}),
-        std::move(promise),
-        [](wrpc::Command *c, std::promise<bool> &p, wrpc::COMMAND_STATUS status) {
-            if (status == wrpc::COMMAND_STATUS::OK)
-                p.set_value(static_cast<wrpc::SetGpuModeCommand *>(c)->response().success);
-            else
-                p.set_exception(std::make_exception_ptr(std::runtime_error("Error setting the gpu run mode")));
-        });
+    schedule_now_(host, job, __func__);
+}
 
-    {
-        WOINC_LOCK_GUARD;
-        schedule_now_(host, job, __func__);
-    }
+template<typename SINK>
+void Controller::Impl::read_global_prefs_override(const std::string &host, SINK sink) {
+    check_not_empty_host_name__(host);
 
-    return future;
+    auto job = new CommandJob<bool, SINK>(
+        new wrpc::ReadGlobalPreferencesOverrideCommand,
+        success__<wrpc::ReadGlobalPreferencesOverrideCommand>,
+        "Error reading the preferences",
+        std::move(sink));
+
+    schedule_now_(host, job, __func__);
 }
 
-std::future<bool> Controller::Impl::network_mode(const std::string &host, RUN_MODE mode) {
+template<typename SINK>
+void Controller::Impl::run_mode(const std::string &host, RUN_MODE mode, SINK sink) {
     check_not_empty_host_name__(host);
 
-    std::promise<bool> promise;
-    auto future = promise.get_future();
+    auto job = new CommandJob<bool, SINK>(
+        new wrpc::SetRunModeCommand(wrpc::SetRunModeRequest{mode}),
+        success__<wrpc::SetRunModeCommand>,
+        "Error setting the run mode",
+        std::move(sink));
+
+    schedule_now_(host, job, __func__);
+}
+
+template<typename SINK>
+void Controller::Impl::gpu_mode(const std::string &host, RUN_MODE mode, SINK sink) {
+    check_not_empty_host_name__(host);
+
+    auto job = new CommandJob<bool, SINK>(
+        new wrpc::SetGpuModeCommand(wrpc::SetGpuModeRequest{mode}),
+        success__<wrpc::SetGpuModeCommand>,
+        "Error setting the gpu run mode",
+        std::move(sink));
+
+    schedule_now_(host, job, __func__);
+}
+
+template<typename SINK>
+void Controller::Impl::network_mode(const std::string &host, RUN_MODE mode, SINK sink) {
+    check_not_empty_host_name__(host);
 
-    auto job = new PromisedResultJob<bool>(
+    auto job = new CommandJob<bool, SINK>(
         new wrpc::SetNetworkModeCommand(wrpc::SetNetworkModeRequest{mode}),
-        std::move(promise),
-        [](wrpc::Command *c, std::promise<bool> &p, wrpc::COMMAND_STATUS status) {
-            if (status == wrpc::COMMAND_STATUS::OK)
-                p.set_value(static_cast<wrpc::SetNetworkModeCommand *>(c)->response().success);
-            else
-                p.set_exception(std::make_exception_ptr(std::runtime_error("Error setting the network mode")));
-        });
+        success__<wrpc::SetNetworkModeCommand>,
+        "Error setting the network mode",
+        std::move(sink));
+
+    schedule_now_(host, job, __func__);
+}
+
+template<typename SINK>
+void Controller::Impl::bulk_task_op(TASK_OP op, std::vector<TaskTarget> targets, BulkProgress progress,
+                                    Executor executor, std::size_t max_targets_per_job, SINK sink) {
+    if (max_targets_per_job == 0)
+        throw std::invalid_argument("Invalid number of targets per job");
+    for (const auto &target : targets) {
+        check_not_empty_host_name__(target.host);
+        check_not_empty__(target.master_url, "Missing master url");
+        check_not_empty__(target.task_name, "Missing task name");
+    }
 
     {
         WOINC_LOCK_GUARD;
-        schedule_now_(host, job, __func__);
+        verify_not_shutdown_();
     }
 
-    return future;
+    if (targets.empty()) {
+        sink.set_value(BulkResult());
+        return;
+    }
+
+    std::map<std::string, std::vector<std::size_t>> indices_by_host;
+    for (std::size_t i = 0; i < targets.size(); ++i)
+        indices_by_host[targets[i].host].push_back(i);
+
+    auto operation = std::make_shared<BulkOperation<TaskTarget, SINK>>(
+        std::move(targets), std::move(sink), std::move(progress), std::move(executor));
+
+    // the hosts execute their jobs in parallel, each one after the other
+    for (const auto &host_indices : indices_by_host) {
+        const auto &host = host_indices.first;
+        const auto &indices = host_indices.second;
+
+        for (std::size_t begin = 0; begin < indices.size(); begin += max_targets_per_job) {
+            std::vector<std::size_t> chunk(indices.begin() + static_cast<std::ptrdiff_t>(begin),
+                                           indices.begin() + static_cast<std::ptrdiff_t>(
+                                               std::min(begin + max_targets_per_job, indices.size())));
+
+            auto job = new BulkTaskOpJob<SINK>(op, operation, chunk);
+
+            // a single host must not fail the whole operation
+            std::string error;
+            try {
+                schedule_now_(host, job, PeriodicTask::GET_TASKS, __func__);
+            } catch (const ShutdownException &) {
+                error = "The controller is shut down";
+            } catch (const UnknownHostException &) {
+                error = "Unknown host \"" + host + "\"";
+            } catch (const QueueFullException &) {
+                error = "The job queue of host \"" + host + "\" is full";
+            }
+
+            if (!error.empty())
+                for (auto index : chunk)
+                    operation->finish(index, false, error);
+        }
+    }
+}
+
+std::shared_ptr<HostController> Controller::Impl::add_host_(const std::string &host) {
+    if (has_host_(host))
+        throw std::invalid_argument("Host \"" + host + "\" already registered.");
+
+    auto host_controller = std::make_shared<HostController>(host, handler_registry_);
+
+    configuration_.add_host(host);
+    host_controllers_.emplace(host, host_controller);
+    // periodic tasks are not scheduled yet
+    periodic_tasks_scheduler_context_.add_host(host, *host_controller);
+
+    handler_registry_.for_host_handler([&](auto &handler) {
+        handler.on_host_added(host);
+    });
+
+    return host_controller;
 }
 
 void Controller::Impl::remove_host_(std::string host) {
@@ -534,6 +876,25 @@ bool Controller::Impl::has_host_(const std::string &name) const {
     return host_controllers_.find(name) != host_controllers_.end();
 }
 
+void Controller::Impl::verify_not_shutdown_() const {
+    if (shutdown_)
+        throw ShutdownException();
+}
+
+#ifndef NDEBUG
+void Controller::Impl::verify_known_host_(const std::string &host, const char *func) const {
+#else
+void Controller::Impl::verify_known_host_(const std::string &host, const char *) const {
+#endif
+    assert(func != nullptr);
+    if (!has_host_(host)) {
+#ifndef NDEBUG
+        std::cerr << "Controller::" << func << " on non existing host \"" << host << "\" called\n";
+#endif
+        throw UnknownHostException{host};
+    }
+}
+
 #ifndef NDEBUG
 void Controller::Impl::schedule_now_(const std::string &host, Job *job, const char *func) {
 #else
@@ -542,45 +903,60 @@ void Controller::Impl::schedule_now_(const std::string &host, Job *job, const ch
     assert(job != nullptr);
     assert(func != nullptr);
 
-    decltype(host_controllers_.find(host)) hc;
+    std::shared_ptr<HostController> host_controller;
 
     try {
+        WOINC_LOCK_GUARD;
+
         if (shutdown_)
             throw ShutdownException();
 
-        hc = host_controllers_.find(host);
+        auto hc = host_controllers_.find(host);
         if (hc == host_controllers_.end()) {
 #ifndef NDEBUG
             std::cerr << "Controller::" << func << " on non existing host \"" << host << "\" called\n";
 #endif
             throw UnknownHostException{host};
         }
+
+        host_controller = hc->second;
     } catch (...) {
         delete job;
         throw;
     }
 
     // not in the tye-catch-block as the job queue takes ownership of the job
-    hc->second->schedule_now(job);
+    // user triggered jobs are interactive and therefore executed before any periodic job
+    assert(job->priority() == JobPriority::INTERACTIVE);
+    if (!host_controller->schedule(job))
+        throw QueueFullException{host};
 }
 
-void Controller::Impl::verify_not_shutdown_() const {
-    if (shutdown_)
-        throw ShutdownException();
+bool Controller::Impl::connect_(std::string host, std::shared_ptr<HostController> host_controller,
+                                std::string url, std::uint16_t port, std::function<void(bool)> callback,
+                                std::function<void()> cancelled) {
+    // the connect may block for a long time (see man 2 connect), therefore it's done by the connector
+    return connector_.submit([this, host = std::move(host), host_controller = std::move(host_controller),
+                              url = std::move(url), port, callback = std::move(callback)]() {
+        bool connected = host_controller->connect(url, port);
+        handler_registry_.for_host_handler([&](HostHandler &handler) {
+            if (connected)
+                handler.on_host_connected(host);
+            else
+                handler.on_host_error(host, Error::CONNECTION_ERROR);
+        });
+        if (callback)
+            callback(connected);
+    }, std::move(cancelled));
 }
 
-#ifndef NDEBUG
-void Controller::Impl::verify_known_host_(const std::string &host, const char *func) const {
-#else
-void Controller::Impl::verify_known_host_(const std::string &host, const char *) const {
-#endif
-    assert(func != nullptr);
-    if (!has_host_(host)) {
-#ifndef NDEBUG
-        std::cerr << "Controller::" << func << " on non existing host \"" << host << "\" called\n";
-#endif
-        throw UnknownHostException{host};
-    }
+void Controller::Impl::schedule_now_(const std::string &host, Job *job, PeriodicTask to_reschedule, const char *func) {
+    schedule_now_(host, job, func);
+
+    WOINC_LOCK_GUARD;
+    // the host may have been removed in the meantime
+    if (!shutdown_ && has_host_(host))
+        periodic_tasks_scheduler_context_.reschedule_now(host, to_reschedule);
 }
 
 
@@ -614,12 +990,48 @@ void Controller::deregister_handler(PeriodicTaskHandler *handler) {
     impl_->deregister_handler(handler);
 }
 
+void Controller::register_handler(DeltaHandler *handler) {
+    impl_->register_handler(handler);
+}
+
+void Controller::deregister_handler(DeltaHandler *handler) {
+    impl_->deregister_handler(handler);
+}
+
+void Controller::register_handler(MetricsHandler *handler) {
+    impl_->register_handler(handler);
+}
+
+void Controller::deregister_handler(MetricsHandler *handler) {
+    impl_->deregister_handler(handler);
+}
+
 void Controller::add_host(const std::string &host,
                           const std::string &url,
                           std::uint16_t port) {
     impl_->add_host(host, url, port);
 }
 
+std::future<AddHostsResult> Controller::add_hosts(std::vector<HostTarget> hosts, BulkProgress progress) {
+    return promised__<AddHostsResult>([&](auto sink) {
+        impl_->add_hosts(std::move(hosts), std::move(progress), Executor(), std::move(sink));
+    });
+}
+
+void Controller::add_hosts(std::vector<HostTarget> hosts, Completion<AddHostsResult> completion,
+                           Executor executor, BulkProgress progress) {
+    auto sink = completion_sink__(std::move(completion), executor);
+    impl_->add_hosts(std::move(hosts), std::move(progress), std::move(executor), std::move(sink));
+}
+
+void Controller::max_concurrent_connects(std::size_t max_connects) {
+    impl_->max_concurrent_connects(max_connects);
+}
+
+std::size_t Controller::max_concurrent_connects() const {
+    return impl_->max_concurrent_connects();
+}
+
 void Controller::authorize_host(const std::string &host,
                                 const std::string &password) {
     impl_->authorize_host(host, password);
@@ -641,6 +1053,26 @@ int Controller::periodic_task_interval(const PeriodicTask task) const {
     return impl_->periodic_task_interval(task);
 }
 
+void Controller::periodic_task_interval(const std::string &host, PeriodicTask task, int seconds) {
+    impl_->periodic_task_interval(host, task, seconds);
+}
+
+void Controller::group_periodic_task_interval(const std::string &group, PeriodicTask task, int seconds) {
+    impl_->group_periodic_task_interval(group, task, seconds);
+}
+
+int Controller::periodic_task_interval(const std::string &host, PeriodicTask task) const {
+    return impl_->periodic_task_interval(host, task);
+}
+
+void Controller::host_group(const std::string &host, const std::string &group) {
+    impl_->host_group(host, group);
+}
+
+std::string Controller::host_group(const std::string &host) const {
+    return impl_->host_group(host);
+}
+
 void Controller::schedule_periodic_tasks(const std::string &host, bool value) {
     impl_->schedule_periodic_tasks(host, value);
 }
@@ -653,45 +1085,166 @@ void Controller::active_only_tasks(const std::string &host, bool value) {
     impl_->active_only_tasks(host, value);
 }
 
+void Controller::subscribe(const PeriodicTaskHandler *handler, const std::string &host,
+                           PeriodicTask task, int max_staleness) {
+    impl_->subscribe(handler, host, task, max_staleness);
+}
+
+void Controller::unsubscribe(const PeriodicTaskHandler *handler, const std::string &host, PeriodicTask task) {
+    impl_->unsubscribe(handler, host, task);
+}
+
+void Controller::unsubscribe(const PeriodicTaskHandler *handler, const std::string &host) {
+    impl_->unsubscribe(handler, host);
+}
+
+HostState Controller::snapshot(const std::string &host) const {
+    return impl_->snapshot(host);
+}
+
+std::uint64_t Controller::version(const std::string &host, Entity entity) const {
+    return impl_->version(host, entity);
+}
+
+Metrics Controller::metrics() const {
+    return impl_->metrics();
+}
+
+void Controller::job_queue_capacity(const std::string &host, std::size_t capacity, QueueOverflowPolicy policy) {
+    impl_->job_queue_capacity(host, capacity, policy);
+}
+
+void Controller::job_staleness_limit(const std::string &host, int seconds) {
+    impl_->job_staleness_limit(host, seconds);
+}
+
+void Controller::rate_limit(const std::string &host, RateLimit limit) {
+    impl_->rate_limit(host, limit);
+}
+
+RateLimit Controller::rate_limit(const std::string &host) const {
+    return impl_->rate_limit(host);
+}
+
 std::future<bool> Controller::file_transfer_op(const std::string &host, FILE_TRANSFER_OP op,
                                                const std::string &master_url, const std::string &filename) {
-    return impl_->file_transfer_op(host, op, master_url, filename);
+    return promised__<bool>([&](auto sink) {
+        impl_->file_transfer_op(host, op, master_url, filename, std::move(sink));
+    });
 }
 
 std::future<bool> Controller::project_op(const std::string &host, PROJECT_OP op, const std::string &master_url) {
-    return impl_->project_op(host, op, master_url);
+    return promised__<bool>([&](auto sink) {
+        impl_->project_op(host, op, master_url, std::move(sink));
+    });
 }
 
 std::future<bool> Controller::task_op(const std::string &host, TASK_OP op,
                          const std::string &master_url, const std::string &task_name) {
-    return impl_->task_op(host, op, master_url, task_name);
+    return promised__<bool>([&](auto sink) {
+        impl_->task_op(host, op, master_url, task_name, std::move(sink));
+    });
 }
 
 std::future<GlobalPreferences> Controller::load_global_preferences(const std::string &host,
                                                                    GET_GLOBAL_PREFS_MODE mode) {
-    return impl_->load_global_preferences(host, mode);
+    return promised__<GlobalPreferences>([&](auto sink) {
+        impl_->load_global_preferences(host, mode, std::move(sink));
+    });
 }
 
 std::future<bool> Controller::save_global_preferences(const std::string &host,
                                                       const GlobalPreferences &prefs,
                                                       const GlobalPreferencesMask &mask) {
-    return impl_->save_global_preferences(host, prefs, mask);
+    return promised__<bool>([&](auto sink) {
+        impl_->save_global_preferences(host, prefs, mask, std::move(sink));
+    });
 }
 
 std::future<bool> Controller::read_global_prefs_override(const std::string &host) {
-    return impl_->read_global_prefs_override(host);
+    return promised__<bool>([&](auto sink) {
+        impl_->read_global_prefs_override(host, std::move(sink));
+    });
 }
 
 std::future<bool> Controller::gpu_mode(const std::string &host, RUN_MODE mode) {
-    return impl_->gpu_mode(host, mode);
+    return promised__<bool>([&](auto sink) {
+        impl_->gpu_mode(host, mode, std::move(sink));
+    });
 }
 
 std::future<bool> Controller::network_mode(const std::string &host, RUN_MODE mode) {
-    return impl_->network_mode(host, mode);
+    return promised__<bool>([&](auto sink) {
+        impl_->network_mode(host, mode, std::move(sink));
+    });
 }
 
 std::future<bool> Controller::run_mode(const std::string &host, RUN_MODE mode) {
-    return impl_->run_mode(host, mode);
+    return promised__<bool>([&](auto sink) {
+        impl_->run_mode(host, mode, std::move(sink));
+    });
+}
+
+std::future<BulkResult> Controller::bulk_task_op(TASK_OP op, std::vector<TaskTarget> targets,
+                                                BulkProgress progress, std::size_t max_targets_per_job) {
+    return promised__<BulkResult>([&](auto sink) {
+        impl_->bulk_task_op(op, std::move(targets), std::move(progress), Executor(),
+                            max_targets_per_job, std::move(sink));
+    });
+}
+
+void Controller::bulk_task_op(TASK_OP op, std::vector<TaskTarget> targets,
+                              Completion<BulkResult> completion, Executor executor,
+                              BulkProgress progress, std::size_t max_targets_per_job) {
+    auto sink = completion_sink__(std::move(completion), executor);
+    impl_->bulk_task_op(op, std::move(targets), std::move(progress), std::move(executor),
+                        max_targets_per_job, std::move(sink));
+}
+
+void Controller::file_transfer_op(const std::string &host, FILE_TRANSFER_OP op,
+                                  const std::string &master_url, const std::string &filename,
+                                  Completion<bool> completion, Executor executor) {
+    impl_->file_transfer_op(host, op, master_url, filename,
+                            completion_sink__(std::move(completion), std::move(executor)));
+}
+
+void Controller::project_op(const std::string &host, PROJECT_OP op, const std::string &master_url,
+                            Completion<bool> completion, Executor executor) {
+    impl_->project_op(host, op, master_url, completion_sink__(std::move(completion), std::move(executor)));
+}
+
+void Controller::task_op(const std::string &host, TASK_OP op,
+                         const std::string &master_url, const std::string &task_name,
+                         Completion<bool> completion, Executor executor) {
+    impl_->task_op(host, op, master_url, task_name, completion_sink__(std::move(completion), std::move(executor)));
+}
+
+void Controller::load_global_preferences(const std::string &host, GET_GLOBAL_PREFS_MODE mode,
+                                         Completion<GlobalPreferences> completion, Executor executor) {
+    impl_->load_global_preferences(host, mode, completion_sink__(std::move(completion), std::move(executor)));
+}
+
+void Controller::save_global_preferences(const std::string &host,
+                                         const GlobalPreferences &prefs,
+                                         const GlobalPreferencesMask &mask,
+                                         Completion<bool> completion, Executor executor) {
+    impl_->save_global_preferences(host, prefs, mask, completion_sink__(std::move(completion), std::move(executor)));
+}
+
+void Controller::read_global_prefs_override(const std::string &host, Completion<bool> completion, Executor executor) {
+    impl_->read_global_prefs_override(host, completion_sink__(std::move(completion), std::move(executor)));
+}
+
+void Controller::gpu_mode(const std::string &host, RUN_MODE mode, Completion<bool> completion, Executor executor) {
+    impl_->gpu_mode(host, mode, completion_sink__(std::move(completion), std::move(executor)));
+}
+
+void Controller::network_mode(const std::string &host, RUN_MODE mode, Completion<bool> completion, Executor executor) {
+    impl_->network_mode(host, mode, completion_sink__(std::move(completion), std::move(executor)));
+}
+
+void Controller::run_mode(const std::string &host, RUN_MODE mode, Completion<bool> completion, Executor executor) {
+    impl_->run_mode(host, mode, completion_sink__(std::move(completion), std::move(executor)));
 }
 
 }}
@@ -0,0 +1,334 @@
+/* libui/src/delta_tracker.cc --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+#include "delta_tracker.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+using namespace woinc::ui;
+
+// ---- keys ----
+
+std::string key__(const woinc::FileTransfer &file_transfer) {
+    return file_transfer.project_url + '\n' + file_transfer.name;
+}
+
+std::string key__(const woinc::Project &project) {
+    return project.master_url;
+}
+
+std::string key__(const woinc::Task &task) {
+    return task.project_url + '\n' + task.name;
+}
+
+// ---- changed fields ----
+
+bool equal__(const woinc::GuiUrl &a, const woinc::GuiUrl &b) {
+    return a.name == b.name
+        && a.description == b.description
+        && a.url == b.url
+        && a.ifteam == b.ifteam;
+}
+
+FieldMask changed_fields__(const woinc::FileTransfer &a, const woinc::FileTransfer &b) {
+    FieldMask fields = 0;
+
+    if (a.status != b.status
+            || a.project_backoff != b.project_backoff)
+        fields |= FileTransferFields::STATUS;
+
+    if (static_cast<bool>(a.file_xfer) != static_cast<bool>(b.file_xfer)
+            || (a.file_xfer && (a.file_xfer->bytes_xferred != b.file_xfer->bytes_xferred
+                                || a.file_xfer->xfer_speed != b.file_xfer->xfer_speed)))
+        fields |= FileTransferFields::PROGRESS;
+
+    if (static_cast<bool>(a.persistent_file_xfer) != static_cast<bool>(b.persistent_file_xfer)
+            || (a.persistent_file_xfer && (a.persistent_file_xfer->is_upload != b.persistent_file_xfer->is_upload
+                                           || a.persistent_file_xfer->time_so_far != b.persistent_file_xfer->time_so_far
+                                           || a.persistent_file_xfer->next_request_time != b.persistent_file_xfer->next_request_time)))
+        fields |= FileTransferFields::RETRIES;
+
+    if (a.nbytes != b.nbytes
+            || a.project_name != b.project_name)
+        fields |= FileTransferFields::OTHER;
+
+#ifdef WOINC_EXPOSE_FULL_STRUCTURES
+    // the presence of the transfers has been compared above
+    if (a.file_xfer && b.file_xfer) {
+        if (a.file_xfer->file_offset != b.file_xfer->file_offset)
+            fields |= FileTransferFields::PROGRESS;
+        if (a.file_xfer->url != b.file_xfer->url)
+            fields |= FileTransferFields::OTHER;
+    }
+
+    if (a.persistent_file_xfer && b.persistent_file_xfer
+            && (a.persistent_file_xfer->last_bytes_xferred != b.persistent_file_xfer->last_bytes_xferred
+                || a.persistent_file_xfer->num_retries != b.persistent_file_xfer->num_retries
+                || a.persistent_file_xfer->first_request_time != b.persistent_file_xfer->first_request_time))
+        fields |= FileTransferFields::RETRIES;
+
+    if (a.max_nbytes != b.max_nbytes)
+        fields |= FileTransferFields::OTHER;
+#endif
+
+    return fields;
+}
+
+FieldMask changed_fields__(const woinc::Project &a, const woinc::Project &b) {
+    FieldMask fields = 0;
+
+    if (a.anonymous_platform != b.anonymous_platform
+            || a.attached_via_acct_mgr != b.attached_via_acct_mgr
+            || a.detach_when_done != b.detach_when_done
+            || a.dont_request_more_work != b.dont_request_more_work
+            || a.ended != b.ended
+            || a.master_url_fetch_pending != b.master_url_fetch_pending
+            || a.non_cpu_intensive != b.non_cpu_intensive
+            || a.scheduler_rpc_in_progress != b.scheduler_rpc_in_progress
+            || a.suspended_via_gui != b.suspended_via_gui
+            || a.trickle_up_pending != b.trickle_up_pending
+            || a.sched_rpc_pending != b.sched_rpc_pending)
+        fields |= ProjectFields::STATUS;
+
+    if (a.host_expavg_credit != b.host_expavg_credit
+            || a.host_total_credit != b.host_total_credit
+            || a.user_expavg_credit != b.user_expavg_credit
+            || a.user_total_credit != b.user_total_credit)
+        fields |= ProjectFields::CREDIT;
+
+    if (a.resource_share != b.resource_share
+            || a.sched_priority != b.sched_priority
+            || a.elapsed_time != b.elapsed_time)
+        fields |= ProjectFields::SCHEDULING;
+
+    if (a.njobs_error != b.njobs_error
+            || a.njobs_success != b.njobs_success)
+        fields |= ProjectFields::JOBS;
+
+    if (a.download_backoff != b.download_backoff
+            || a.upload_backoff != b.upload_backoff
+            || a.last_rpc_time != b.last_rpc_time
+            || a.min_rpc_time != b.min_rpc_time
+            || a.master_fetch_failures != b.master_fetch_failures
+            || a.nrpc_failures != b.nrpc_failures)
+        fields |= ProjectFields::BACKOFFS;
+
+    if (a.project_name != b.project_name
+            || a.team_name != b.team_name
+            || a.user_name != b.user_name
+            || a.venue != b.venue
+            || a.external_cpid != b.external_cpid
+            || a.hostid != b.hostid
+            || a.gui_urls.size() != b.gui_urls.size()
+            || !std::equal(a.gui_urls.cbegin(), a.gui_urls.cend(), b.gui_urls.cbegin(), equal__))
+        fields |= ProjectFields::ACCOUNT;
+
+    if (a.desired_disk_usage != b.desired_disk_usage
+            || a.project_files_downloaded_time != b.project_files_downloaded_time)
+        fields |= ProjectFields::DISK_USAGE;
+
+#ifdef WOINC_EXPOSE_FULL_STRUCTURES
+    if (a.next_rpc_time != b.next_rpc_time)
+        fields |= ProjectFields::BACKOFFS;
+
+    if (a.teamid != b.teamid
+            || a.userid != b.userid
+            || a.host_venue != b.host_venue
+            || a.email_hash != b.email_hash
+            || a.cross_project_id != b.cross_project_id)
+        fields |= ProjectFields::ACCOUNT;
+
+    if (a.dont_use_dcf != b.dont_use_dcf
+            || a.send_full_workload != b.send_full_workload
+            || a.use_symlinks != b.use_symlinks
+            || a.verify_files_on_app_start != b.verify_files_on_app_start
+            || a.ams_resource_share_new != b.ams_resource_share_new
+            || a.cpid_time != b.cpid_time
+            || a.duration_correction_factor != b.duration_correction_factor
+            || a.host_create_time != b.host_create_time
+            || a.rec != b.rec
+            || a.rec_time != b.rec_time
+            || a.user_create_time != b.user_create_time
+            || a.rpc_seqno != b.rpc_seqno
+            || a.send_job_log != b.send_job_log
+            || a.send_time_stats_log != b.send_time_stats_log
+            || a.project_dir != b.project_dir
+            || a.symstore != b.symstore)
+        fields |= ProjectFields::OTHER;
+#endif
+
+    return fields;
+}
+
+FieldMask changed_fields__(const woinc::Task &a, const woinc::Task &b) {
+    FieldMask fields = 0;
+
+    if (a.state != b.state
+            || a.exit_status != b.exit_status
+            || a.signal != b.signal)
+        fields |= TaskFields::STATE;
+
+    if (a.coproc_missing != b.coproc_missing
+            || a.got_server_ack != b.got_server_ack
+            || a.network_wait != b.network_wait
+            || a.project_suspended_via_gui != b.project_suspended_via_gui
+            || a.ready_to_report != b.ready_to_report
+            || a.scheduler_wait != b.scheduler_wait
+            || a.suspended_via_gui != b.suspended_via_gui)
+        fields |= TaskFields::FLAGS;
+
+    if (a.estimated_cpu_time_remaining != b.estimated_cpu_time_remaining)
+        fields |= TaskFields::ESTIMATES;
+
+    if (a.final_cpu_time != b.final_cpu_time
+            || a.final_elapsed_time != b.final_elapsed_time)
+        fields |= TaskFields::FINAL_TIMES;
+
+    if (a.resources != b.resources
+            || a.scheduler_wait_reason != b.scheduler_wait_reason)
+        fields |= TaskFields::SCHEDULING;
+
+    if (a.received_time != b.received_time
+            || a.report_deadline != b.report_deadline)
+        fields |= TaskFields::DEADLINES;
+
+    if (a.version_num != b.version_num
+            || a.wu_name != b.wu_name)
+        fields |= TaskFields::OTHER;
+
+#ifdef WOINC_EXPOSE_FULL_STRUCTURES
+    if (a.edf_scheduled != b.edf_scheduled
+            || a.report_immediately != b.report_immediately)
+        fields |= TaskFields::FLAGS;
+
+    if (a.completed_time != b.completed_time)
+        fields |= TaskFields::FINAL_TIMES;
+
+    if (a.plan_class != b.plan_class
+            || a.platform != b.platform)
+        fields |= TaskFields::OTHER;
+#endif
+
+    if (static_cast<bool>(a.active_task) != static_cast<bool>(b.active_task)) {
+        fields |= TaskFields::ACTIVE_TASK | TaskFields::PROGRESS | TaskFields::RESOURCE_USAGE;
+    } else if (a.active_task) {
+        const auto &x = *a.active_task;
+        const auto &y = *b.active_task;
+
+        if (x.active_task_state != y.active_task_state
+                || x.scheduler_state != y.scheduler_state
+                || x.needs_shmem != y.needs_shmem
+                || x.too_large != y.too_large
+                || x.pid != y.pid
+                || x.slot != y.slot)
+            fields |= TaskFields::ACTIVE_TASK;
+
+        if (x.fraction_done != y.fraction_done
+                || x.progress_rate != y.progress_rate
+                || x.elapsed_time != y.elapsed_time
+                || x.current_cpu_time != y.current_cpu_time
+                || x.checkpoint_cpu_time != y.checkpoint_cpu_time)
+            fields |= TaskFields::PROGRESS;
+
+        if (x.working_set_size_smoothed != y.working_set_size_smoothed
+                || x.swap_size != y.swap_size
+                || x.bytes_received != y.bytes_received
+                || x.bytes_sent != y.bytes_sent)
+            fields |= TaskFields::RESOURCE_USAGE;
+
+#ifdef WOINC_EXPOSE_FULL_STRUCTURES
+        if (x.working_set_size != y.working_set_size
+                || x.page_fault_rate != y.page_fault_rate)
+            fields |= TaskFields::RESOURCE_USAGE;
+
+        if (x.app_version_num != y.app_version_num
+                || x.graphics_exec_path != y.graphics_exec_path
+                || x.remote_desktop_addr != y.remote_desktop_addr
+                || x.slot_path != y.slot_path
+                || x.web_graphics_url != y.web_graphics_url)
+            fields |= TaskFields::OTHER;
+#endif
+    }
+
+    return fields;
+}
+
+// ---- diffing ----
+
+template<typename ENTITY>
+Delta<ENTITY> update__(std::unordered_map<std::string, ENTITY> &last, const std::vector<ENTITY> &entities) {
+    Delta<ENTITY> delta;
+
+    std::unordered_map<std::string, ENTITY> current;
+    current.reserve(entities.size());
+
+    for (const auto &entity : entities) {
+        auto key = key__(entity);
+        auto old = last.find(key);
+
+        if (old == last.end()) {
+            delta.added.push_back(entity);
+            current.emplace(std::move(key), entity);
+        } else {
+            auto fields = changed_fields__(old->second, entity);
+            if (fields != 0) {
+                delta.changed.push_back(typename Delta<ENTITY>::Change{entity, fields});
+                current.emplace(std::move(key), entity);
+            } else {
+                // unchanged, so reuse the old entity instead of copying the new one
+                current.emplace(std::move(key), std::move(old->second));
+            }
+            last.erase(old);
+        }
+    }
+
+    // the remaining entities haven't been received again
+    for (auto &removed : last)
+        delta.removed.push_back(std::move(removed.second));
+
+    last = std::move(current);
+
+    return delta;
+}
+
+}
+
+namespace woinc { namespace ui {
+
+FileTransfersDelta DeltaTracker::update(const woinc::FileTransfers &file_transfers) {
+    return update__(file_transfers_, file_transfers);
+}
+
+ProjectsDelta DeltaTracker::update(const woinc::Projects &projects) {
+    return update__(projects_, projects);
+}
+
+TasksDelta DeltaTracker::update(const woinc::Tasks &tasks) {
+    return update__(tasks_, tasks);
+}
+
+void DeltaTracker::reset() {
+    file_transfers_.clear();
+    projects_.clear();
+    tasks_.clear();
+}
+
+}}
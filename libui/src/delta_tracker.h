@@ -0,0 +1,54 @@
+/* libui/src/delta_tracker.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef WOINC_UI_DELTA_TRACKER_H_
+#define WOINC_UI_DELTA_TRACKER_H_
+
+#include <string>
+#include <unordered_map>
+
+#include <woinc/types.h>
+#include <woinc/ui/delta.h>
+
+#include "visibility.h"
+
+namespace woinc { namespace ui {
+
+// Keeps the last received keyed entities of a host to compute the deltas for the delta handlers.
+// The tracker is used by the worker thread of its host only and therefore not threadsafe.
+class WOINCUI_LOCAL DeltaTracker {
+    public:
+        FileTransfersDelta update(const woinc::FileTransfers &file_transfers);
+        ProjectsDelta update(const woinc::Projects &projects);
+        TasksDelta update(const woinc::Tasks &tasks);
+
+        // forget the last received entities, the next update reports all entities as added
+        void reset();
+
+    private:
+        template<typename ENTITY>
+        using Entities = std::unordered_map<std::string, ENTITY>;
+
+        Entities<woinc::FileTransfer> file_transfers_;
+        Entities<woinc::Project> projects_;
+        Entities<woinc::Task> tasks_;
+};
+
+}}
+
+#endif
@@ -19,45 +19,158 @@
 #include "handler_registry.h"
 
 #include <algorithm>
+#include <utility>
 
 namespace woinc { namespace ui {
 
 #define WOINC_LOCK_GUARD std::lock_guard<decltype(lock_)> guard(lock_)
 
+namespace {
+
+template<typename HANDLER>
+void destroy__(const void *handlers) {
+    delete static_cast<const std::vector<HANDLER *> *>(handlers);
+}
+
+}
+
+// --- HandlerRegistry::ReadSection ---
+
+HandlerRegistry::ReadSection::ReadSection(const HandlerRegistry &registry) : registry_(registry) {
+    // if the epoch changed in the meantime, a writer may already be waiting for the counter of the old epoch
+    while (true) {
+        const auto epoch = registry_.epoch_.load();
+        slot_ = epoch % registry_.readers_.size();
+        registry_.readers_[slot_].fetch_add(1);
+        if (registry_.epoch_.load() == epoch)
+            break;
+        registry_.leave_read_section_(slot_);
+    }
+}
+
+HandlerRegistry::ReadSection::~ReadSection() {
+    registry_.leave_read_section_(slot_);
+}
+
+// --- HandlerRegistry ---
+
+HandlerRegistry::HandlerRegistry()
+    : epoch_(0),
+    readers_ {{ {0}, {0} }},
+    waiting_(false),
+    host_handler_(new std::vector<HostHandler *>()),
+    periodic_task_handler_(new std::vector<PeriodicTaskHandler *>()),
+    delta_handler_(new std::vector<DeltaHandler *>()),
+    metrics_handler_(new std::vector<MetricsHandler *>())
+{}
+
+HandlerRegistry::~HandlerRegistry() {
+    // there are no visitors left when the registry is destroyed
+    for (const auto &retired : retired_)
+        retired.destroy(retired.handlers);
+
+    delete host_handler_.load();
+    delete periodic_task_handler_.load();
+    delete delta_handler_.load();
+    delete metrics_handler_.load();
+}
+
 void HandlerRegistry::register_handler(HostHandler *handler) {
-    WOINC_LOCK_GUARD;
-    host_handler_.push_back(handler);
+    add_(host_handler_, handler);
 }
 
 void HandlerRegistry::deregister_handler(HostHandler *handler) {
-    WOINC_LOCK_GUARD;
-    host_handler_.erase(std::remove(host_handler_.begin(),
-                                    host_handler_.end(),
-                                    handler),
-                        host_handler_.end());
+    remove_(host_handler_, handler);
 }
 
 void HandlerRegistry::register_handler(PeriodicTaskHandler *handler) {
-    WOINC_LOCK_GUARD;
-    periodic_task_handler_.push_back(handler);
+    add_(periodic_task_handler_, handler);
 }
 
 void HandlerRegistry::deregister_handler(PeriodicTaskHandler *handler) {
-    periodic_task_handler_.erase(std::remove(periodic_task_handler_.begin(),
-                                             periodic_task_handler_.end(),
-                                             handler),
-                                 periodic_task_handler_.end());
+    remove_(periodic_task_handler_, handler);
 }
 
-void HandlerRegistry::for_host_handler(std::function<void(HostHandler &handler)> f) const {
-    WOINC_LOCK_GUARD;
-    for (auto &&handler : host_handler_)
-        f(*handler);
+void HandlerRegistry::register_handler(DeltaHandler *handler) {
+    add_(delta_handler_, handler);
+}
+
+void HandlerRegistry::deregister_handler(DeltaHandler *handler) {
+    remove_(delta_handler_, handler);
+}
+
+void HandlerRegistry::register_handler(MetricsHandler *handler) {
+    add_(metrics_handler_, handler);
 }
 
-void HandlerRegistry::for_periodic_task_handler(std::function<void(PeriodicTaskHandler &handler)> f) const {
+void HandlerRegistry::deregister_handler(MetricsHandler *handler) {
+    remove_(metrics_handler_, handler);
+}
+
+template<typename HANDLER>
+void HandlerRegistry::add_(Handlers<HANDLER> &handlers, HANDLER *handler) {
     WOINC_LOCK_GUARD;
-    for (auto &&handler : periodic_task_handler_)
-        f(*handler);
+
+    auto copy = *handlers.load();
+    copy.push_back(handler);
+
+    // the replaced list is reclaimed by the next deregistration
+    replace_(handlers, std::move(copy));
+}
+
+template<typename HANDLER>
+void HandlerRegistry::remove_(Handlers<HANDLER> &handlers, HANDLER *handler) {
+    std::vector<Retired> retired;
+
+    {
+        WOINC_LOCK_GUARD;
+
+        auto copy = *handlers.load();
+        copy.erase(std::remove(copy.begin(), copy.end(), handler), copy.end());
+
+        replace_(handlers, std::move(copy));
+
+        // each of the retired lists may contain the handler
+        retired.swap(retired_);
+    }
+
+    // wait for the visitors still iterating over a retired list without blocking the other writers
+    wait_for_grace_period_();
+
+    for (const auto &r : retired)
+        r.destroy(r.handlers);
+}
+
+template<typename HANDLER>
+void HandlerRegistry::replace_(Handlers<HANDLER> &handlers, std::vector<HANDLER *> replacement) {
+    auto old = handlers.exchange(new std::vector<HANDLER *>(std::move(replacement)));
+    retired_.push_back({old, &destroy__<HANDLER>});
 }
+
+void HandlerRegistry::wait_for_grace_period_() {
+    std::lock_guard<decltype(grace_period_lock_)> grace_period_guard(grace_period_lock_);
+
+    // Advancing the epoch twice waits for both counters, so every visitor which entered before the
+    // lists were replaced left, even if it counted itself in the epoch advanced by a previous writer.
+    // The visitors entering afterwards count themselves in the new epoch and load the new lists.
+    for (int i = 0; i < 2; ++i) {
+        const auto slot = epoch_.fetch_add(1) % readers_.size();
+
+        std::unique_lock<decltype(left_lock_)> guard(left_lock_);
+        waiting_.store(true);
+        left_.wait(guard, [&]() { return readers_[slot].load() == 0; });
+        waiting_.store(false);
+    }
+}
+
+void HandlerRegistry::leave_read_section_(std::size_t slot) const {
+    readers_[slot].fetch_sub(1);
+
+    // locking ensures a waiting writer either sees the decremented counter or gets notified
+    if (waiting_.load()) {
+        { std::lock_guard<decltype(left_lock_)> guard(left_lock_); }
+        left_.notify_all();
+    }
+}
+
 }}
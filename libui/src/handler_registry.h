@@ -19,33 +19,142 @@
 #ifndef WOINC_UI_HANDLER_REGISTRY_H_
 #define WOINC_UI_HANDLER_REGISTRY_H_
 
-#include <functional>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <mutex>
 #include <vector>
 
+#include <woinc/trace.h>
 #include <woinc/ui/handler.h>
 
 #include "visibility.h"
 
 namespace woinc { namespace ui {
 
+// Registering handlers is rare while the handlers are called for each update of each host.
+// Therefore the handlers are stored in immutable copy-on-write lists published by atomic pointers:
+// the visitors iterate over the current list without taking any lock and (de)registering replaces it.
+// The replaced lists are reclaimed after a grace period, i.e. after all visitors which may have loaded
+// them left. To detect this, each visitor is counted by the reader counter of the current epoch.
+// Deregistering waits for the grace period, so the handler may be destroyed afterwards. As a consequence
+// a handler must not deregister itself while being visited.
 class WOINCUI_LOCAL HandlerRegistry {
     public:
+        HandlerRegistry();
+        ~HandlerRegistry();
+
+        HandlerRegistry(const HandlerRegistry &) = delete;
+        HandlerRegistry &operator=(const HandlerRegistry &) = delete;
+
         void register_handler(HostHandler *handler);
         void deregister_handler(HostHandler *handler);
 
         void register_handler(PeriodicTaskHandler *handler);
         void deregister_handler(PeriodicTaskHandler *handler);
 
+        void register_handler(DeltaHandler *handler);
+        void deregister_handler(DeltaHandler *handler);
+
+        void register_handler(MetricsHandler *handler);
+        void deregister_handler(MetricsHandler *handler);
+
     public:
-        void for_host_handler(std::function<void(HostHandler &handler)> f) const;
-        void for_periodic_task_handler(std::function<void(PeriodicTaskHandler &handler)> f) const;
+        template<typename VISITOR>
+        void for_host_handler(VISITOR &&visitor) const {
+            visit_(host_handler_, visitor);
+        }
+
+        template<typename VISITOR>
+        void for_periodic_task_handler(VISITOR &&visitor) const {
+            visit_(periodic_task_handler_, visitor);
+        }
+
+        template<typename VISITOR>
+        void for_delta_handler(VISITOR &&visitor) const {
+            visit_(delta_handler_, visitor);
+        }
+
+        template<typename VISITOR>
+        void for_metrics_handler(VISITOR &&visitor) const {
+            visit_(metrics_handler_, visitor);
+        }
+
+        bool has_delta_handler() const {
+            ReadSection section(*this);
+            return !delta_handler_.load()->empty();
+        }
+
+    private:
+        template<typename HANDLER>
+        using Handlers = std::atomic<const std::vector<HANDLER *> *>;
+
+        // marks a visitor, the lists loaded within the section aren't reclaimed until it's left
+        class ReadSection {
+            public:
+                explicit ReadSection(const HandlerRegistry &registry);
+                ~ReadSection();
+
+                ReadSection(const ReadSection &) = delete;
+                ReadSection &operator=(const ReadSection &) = delete;
+
+            private:
+                const HandlerRegistry &registry_;
+                std::size_t slot_;
+        };
+
+        template<typename HANDLER, typename VISITOR>
+        void visit_(const Handlers<HANDLER> &handlers, VISITOR &visitor) const {
+            WOINC_TRACE_SPAN("handler.dispatch");
+            ReadSection section(*this);
+            for (auto handler : *handlers.load())
+                visitor(*handler);
+        }
+
+        template<typename HANDLER>
+        void add_(Handlers<HANDLER> &handlers, HANDLER *handler);
+
+        template<typename HANDLER>
+        void remove_(Handlers<HANDLER> &handlers, HANDLER *handler);
+
+        // to be called while being locked, the replaced list is retired
+        template<typename HANDLER>
+        void replace_(Handlers<HANDLER> &handlers, std::vector<HANDLER *> replacement);
+
+        // waits until all visitors, which may still use a retired list, left
+        void wait_for_grace_period_();
+
+        void leave_read_section_(std::size_t slot) const;
 
     private:
-        mutable std::mutex lock_;
+        struct Retired {
+            const void *handlers;
+            void (*destroy)(const void *handlers);
+        };
+
+        // serializes the writers only
+        std::mutex lock_;
+
+        // the replaced lists, which may still be used by visitors
+        std::vector<Retired> retired_;
+
+        // the visitors are counted per epoch, the writers only wait for the counter of a previous epoch
+        std::atomic<std::size_t> epoch_;
+        mutable std::array<std::atomic<std::size_t>, 2> readers_;
+
+        // serializes the grace periods
+        std::mutex grace_period_lock_;
+
+        // the leaving visitors only notify if a writer is waiting for them
+        mutable std::atomic<bool> waiting_;
+        mutable std::mutex left_lock_;
+        mutable std::condition_variable left_;
 
-        std::vector<HostHandler *> host_handler_;
-        std::vector<PeriodicTaskHandler *> periodic_task_handler_;
+        Handlers<HostHandler> host_handler_;
+        Handlers<PeriodicTaskHandler> periodic_task_handler_;
+        Handlers<DeltaHandler> delta_handler_;
+        Handlers<MetricsHandler> metrics_handler_;
 };
 
 }}
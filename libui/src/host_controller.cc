@@ -21,6 +21,8 @@
 #include <cassert>
 #include <thread>
 
+#include <woinc/trace.h>
+
 namespace {
 
 using namespace woinc::ui;
@@ -32,6 +34,8 @@ struct Worker {
     {}
 
     void operator()() {
+        woinc::trace::thread_name("worker " + client_.host());
+
         Job *job;
         do {
             if ((job = job_queue_.pop()) != nullptr) {
@@ -50,7 +54,12 @@ struct Worker {
 
 namespace woinc { namespace ui {
 
-HostController::HostController(const std::string &name) : host_name_(name) {}
+HostController::HostController(const std::string &name, const HandlerRegistry &handler_registry)
+    : host_name_(name),
+    metrics_recorder_(name, handler_registry),
+    client_(metrics_recorder_, rate_limiter_),
+    job_queue_(name)
+{}
 
 HostController::~HostController() {
     shutdown();
@@ -64,27 +73,60 @@ bool HostController::connect(const std::string &url, std::uint16_t port) {
     return true;
 }
 
-void HostController::authorize(const std::string &password, const HandlerRegistry &handler_registry) {
-    schedule(new AuthorizationJob(password, handler_registry));
-}
-
 void HostController::disconnect() {
     client_.disconnect();
 }
 
 void HostController::shutdown() {
+    // don't let the worker wait for the rate limit while shutting down
+    rate_limiter_.shutdown();
     job_queue_.shutdown();
     if (worker_thread_.joinable())
         worker_thread_.join();
     disconnect();
 }
 
-void HostController::schedule_now(Job *job) {
-    job_queue_.push_front(job);
+bool HostController::schedule(Job *job) {
+    return job_queue_.push(job);
+}
+
+void HostController::job_queue_capacity(std::size_t capacity, QueueOverflowPolicy policy) {
+    job_queue_.capacity(capacity, policy);
+}
+
+void HostController::job_staleness_limit(std::chrono::seconds limit) {
+    job_queue_.staleness_limit(limit);
+}
+
+void HostController::rate_limit(RateLimit limit) {
+    rate_limiter_.limit(limit);
+}
+
+RateLimit HostController::rate_limit() const {
+    return rate_limiter_.limit();
+}
+
+JobQueue::Statistics HostController::job_queue_statistics() const {
+    return job_queue_.statistics();
+}
+
+HostMetrics HostController::metrics() const {
+    auto metrics = metrics_recorder_.snapshot();
+    auto statistics = job_queue_.statistics();
+
+    metrics.jobs_rejected = statistics.rejected;
+    metrics.jobs_dropped_overflow = statistics.dropped_overflow;
+    metrics.jobs_dropped_stale = statistics.dropped_stale;
+
+    return metrics;
+}
+
+DeltaTracker &HostController::delta_tracker() {
+    return delta_tracker_;
 }
 
-void HostController::schedule(Job *job) {
-    job_queue_.push_back(job);
+StateCache &HostController::state_cache() {
+    return state_cache_;
 }
 
 }}
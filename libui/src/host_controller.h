@@ -22,8 +22,12 @@
 #include <woinc/ui/controller.h>
 
 #include "client.h"
+#include "delta_tracker.h"
 #include "handler_registry.h"
 #include "job_queue.h"
+#include "metrics_recorder.h"
+#include "rate_limiter.h"
+#include "state_cache.h"
 #include "visibility.h"
 
 namespace woinc { namespace ui {
@@ -32,7 +36,7 @@ namespace woinc { namespace ui {
 // and the only user is the controller, we ensure thread safety there.
 class WOINCUI_LOCAL HostController {
     public:
-        HostController(const std::string &name);
+        HostController(const std::string &name, const HandlerRegistry &handler_registry);
         virtual ~HostController();
 
         HostController(HostController &) = delete;
@@ -43,19 +47,37 @@ class WOINCUI_LOCAL HostController {
 
     public: // called by the controller, error checking and thread safety are done there
         bool connect(const std::string &url, std::uint16_t port);
-        void authorize(const std::string &password, const HandlerRegistry &handler_registry);
         void disconnect();
 
         void shutdown();
 
     public:
-        void schedule_now(Job *job);
-        void schedule(Job *job);
+        // the job is executed according to its priority, see JobQueue
+        // returns false if the job is rejected because the job queue is full
+        bool schedule(Job *job);
+
+        void job_queue_capacity(std::size_t capacity, QueueOverflowPolicy policy);
+        void job_staleness_limit(std::chrono::seconds limit);
+        // limits the RPCs of all jobs
+        void rate_limit(RateLimit limit);
+        RateLimit rate_limit() const;
+        JobQueue::Statistics job_queue_statistics() const;
+
+        HostMetrics metrics() const;
+
+        // to be used by the jobs only, which are executed by the worker thread
+        DeltaTracker &delta_tracker();
+
+        StateCache &state_cache();
 
     private:
         const std::string host_name_;
 
+        MetricsRecorder metrics_recorder_;
+        RateLimiter rate_limiter_;
         Client client_;
+        DeltaTracker delta_tracker_;
+        StateCache state_cache_;
         JobQueue job_queue_;
         std::thread worker_thread_;
 };
@@ -0,0 +1,133 @@
+/* libui/src/inventory.cc --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#include <woinc/ui/inventory.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+using namespace woinc::ui;
+
+bool starts_with__(const std::string &str, const std::string &prefix) {
+    return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+std::invalid_argument inventory_error__(std::size_t line_number, const std::string &msg) {
+    return std::invalid_argument("Invalid inventory line " + std::to_string(line_number) + ": " + msg);
+}
+
+std::uint16_t parse_port__(const std::string &str, std::size_t line_number) {
+    std::size_t parsed = 0;
+    unsigned long port = 0;
+
+    try {
+        port = std::stoul(str, &parsed);
+    } catch (const std::logic_error &) {
+        parsed = 0;
+    }
+
+    if (parsed != str.size() || port == 0 || port > std::numeric_limits<std::uint16_t>::max())
+        throw inventory_error__(line_number, "invalid port \"" + str + "\"");
+
+    return static_cast<std::uint16_t>(port);
+}
+
+std::string resolve_password__(const std::string &source, std::size_t line_number) {
+    static const std::string env_prefix("env:");
+    static const std::string file_prefix("file:");
+    static const std::string literal_prefix("literal:");
+
+    if (starts_with__(source, env_prefix)) {
+        auto name = source.substr(env_prefix.size());
+        const char *value = std::getenv(name.c_str());
+        if (value == nullptr)
+            throw inventory_error__(line_number, "environment variable \"" + name + "\" not set");
+        return value;
+    }
+
+    if (starts_with__(source, file_prefix)) {
+        auto path = source.substr(file_prefix.size());
+        std::ifstream file(path);
+        std::string password;
+        if (!file || !std::getline(file, password))
+            throw inventory_error__(line_number, "could not read the password file \"" + path + "\"");
+        // ignore a windows line ending
+        if (!password.empty() && password.back() == '\r')
+            password.pop_back();
+        return password;
+    }
+
+    if (starts_with__(source, literal_prefix))
+        return source.substr(literal_prefix.size());
+
+    return source;
+}
+
+}
+
+namespace woinc { namespace ui {
+
+std::vector<HostTarget> load_inventory(std::istream &in) {
+    std::vector<HostTarget> hosts;
+
+    std::string line;
+    std::size_t line_number = 0;
+
+    while (std::getline(in, line)) {
+        ++line_number;
+
+        std::istringstream fields(line);
+        std::string first;
+
+        if (!(fields >> first) || first.front() == '#')
+            continue;
+
+        HostTarget host;
+        host.host = std::move(first);
+
+        if (!(fields >> host.url))
+            throw inventory_error__(line_number, "missing url of host \"" + host.host + "\"");
+
+        std::string field;
+        if (fields >> field)
+            host.port = parse_port__(field, line_number);
+        if (fields >> field)
+            host.password = resolve_password__(field, line_number);
+        if (fields >> field)
+            throw inventory_error__(line_number, "unexpected field \"" + field + "\"");
+
+        hosts.push_back(std::move(host));
+    }
+
+    return hosts;
+}
+
+std::vector<HostTarget> load_inventory(const std::string &path) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("Could not open the inventory \"" + path + "\"");
+    return load_inventory(file);
+}
+
+}}
@@ -18,39 +18,103 @@
 
 #include "job_queue.h"
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
+#include <woinc/trace.h>
+
+namespace {
+
+using namespace woinc::ui;
+
+// how long a job of the given priority may wait before it is preferred to jobs with higher priorities,
+// except for interactive jobs, which always run first
+const std::array<std::chrono::milliseconds, 3> AGING_LIMITS__ = {{
+    std::chrono::milliseconds::max(), // INTERACTIVE, never aged
+    std::chrono::milliseconds(2000),  // STATUS
+    std::chrono::milliseconds(10000)  // BULK
+}};
+
+}
+
 namespace woinc { namespace ui {
 
+JobQueue::JobQueue(const std::string &host) : host_(host) {}
+
 JobQueue::~JobQueue() {
     shutdown();
+}
 
-    std::lock_guard<decltype(lock_)> guard(lock_);
-    while (!jobs_.empty()) {
-        delete jobs_.front();
-        jobs_.pop_front();
+bool JobQueue::push(Job *job) {
+    if (job == nullptr)
+        throw std::invalid_argument("Received nullptr instead of a job");
+
+    WOINC_TRACE_SPAN("job_queue.push");
+
+    std::unique_lock<std::mutex> lock(lock_);
+
+    auto &queue = queues_.at(static_cast<size_t>(job->priority()));
+
+    if (!shutdown_ && full_()) {
+        if (policy_ == QueueOverflowPolicy::BLOCK && job->priority() == JobPriority::INTERACTIVE)
+            not_full_condition_.wait(lock, [&]() { return shutdown_ || !full_(); });
+        else if (policy_ == QueueOverflowPolicy::DROP_OLDEST_PERIODIC)
+            drop_oldest_periodic_job_();
+
+        if (!shutdown_ && full_()) {
+            ++statistics_.rejected;
+            lock.unlock();
+            delete job;
+            return false;
+        }
     }
-}
 
-void JobQueue::push_front(Job *job) {
-    push_(job, true);
-}
+    if (shutdown_) {
+        lock.unlock();
+        // the queue takes ownership but as the shutdown is triggered, the job is dropped immediately
+        job->drop(host_);
+        delete job;
+        return true;
+    }
+
+    job->enqueued = Clock::now();
+    queue.push_back(job);
+    lock.unlock();
+    condition_.notify_one();
 
-void JobQueue::push_back(Job *job) {
-    push_(job, false);
+    return true;
 }
 
+// the span includes waiting for a job
 Job *JobQueue::pop() {
+    WOINC_TRACE_SPAN("job_queue.pop");
+
     std::unique_lock<std::mutex> lock(lock_);
 
     while (!shutdown_) {
-        if (jobs_.empty()) {
+        if (!dropped_.empty()) {
+            notify_dropped_jobs_(lock);
+            continue;
+        }
+
+        const auto now = Clock::now();
+        Queue *queue = next_queue_(now);
+
+        if (queue == nullptr) {
             condition_.wait(lock);
+            continue;
+        }
+
+        Job *job = queue->front();
+        assert(job != nullptr);
+        queue->pop_front();
+        not_full_condition_.notify_one();
+
+        if (staleness_limit_ > Clock::duration::zero() && now - job->enqueued > staleness_limit_) {
+            ++statistics_.dropped_stale;
+            dropped_.push_back(job);
         } else {
-            Job *job = jobs_.front();
-            assert(job != nullptr);
-            jobs_.pop_front();
             return job;
         }
     }
@@ -59,30 +123,121 @@ Job *JobQueue::pop() {
 }
 
 void JobQueue::shutdown() {
+    std::vector<Job *> discarded;
+
     lock_.lock();
     shutdown_ = true;
+    // the queued jobs won't be executed anymore, so they are dropped to let their users know
+    discarded.swap(dropped_);
+    for (auto &queue : queues_) {
+        discarded.insert(discarded.end(), queue.begin(), queue.end());
+        queue.clear();
+    }
     lock_.unlock();
 
     condition_.notify_all();
-}
+    not_full_condition_.notify_all();
 
-void JobQueue::push_(Job *job, bool front) {
-    if (job == nullptr)
-        throw std::invalid_argument("Received nullptr instead of a job");
+    for (auto job : discarded) {
+        job->drop(host_);
+        delete job;
+    }
+}
 
+void JobQueue::capacity(std::size_t capacity, QueueOverflowPolicy policy) {
     lock_.lock();
-    if (!shutdown_) {
-        if (front)
-            jobs_.push_front(job);
-        else
-            jobs_.push_back(job);
-        lock_.unlock();
-        condition_.notify_one();
-    } else {
-        lock_.unlock();
-        // the queue takes ownership but as the shutdown is triggered, we simply delete the job
+    capacity_ = capacity;
+    policy_ = policy;
+    lock_.unlock();
+
+    not_full_condition_.notify_all();
+}
+
+void JobQueue::staleness_limit(std::chrono::seconds limit) {
+    std::lock_guard<decltype(lock_)> guard(lock_);
+    staleness_limit_ = limit;
+}
+
+JobQueue::Statistics JobQueue::statistics() const {
+    std::lock_guard<decltype(lock_)> guard(lock_);
+    return statistics_;
+}
+
+JobQueue::Queue *JobQueue::next_queue_(const Clock::time_point &now) {
+    // user triggered jobs are never delayed by aged periodic ones
+    if (!queues_.front().empty())
+        return &queues_.front();
+
+    Queue *next = nullptr;
+
+    // prefer the longest waiting job of all jobs exceeding the aging limit of their priority
+    for (size_t i = 1; i < queues_.size(); ++i) {
+        auto &queue = queues_[i];
+        if (!queue.empty()
+                && now - queue.front()->enqueued >= AGING_LIMITS__[i]
+                && (next == nullptr || queue.front()->enqueued < next->front()->enqueued))
+            next = &queue;
+    }
+
+    if (next != nullptr)
+        return next;
+
+    for (auto &queue : queues_)
+        if (!queue.empty())
+            return &queue;
+
+    return nullptr;
+}
+
+std::size_t JobQueue::size_() const {
+    std::size_t size = 0;
+    for (const auto &queue : queues_)
+        size += queue.size();
+    return size;
+}
+
+bool JobQueue::full_() const {
+    return capacity_ > 0 && size_() >= capacity_;
+}
+
+bool JobQueue::drop_oldest_periodic_job_() {
+    Queue *queue = nullptr;
+    Queue::iterator oldest;
+
+    for (auto &q : queues_) {
+        // the queues are ordered by the enqueue time, so the first periodic job is the oldest one
+        auto job = std::find_if(q.begin(), q.end(), [](const Job *j) {
+            return dynamic_cast<const PeriodicJob *>(j) != nullptr;
+        });
+        if (job != q.end() && (queue == nullptr || (*job)->enqueued < (*oldest)->enqueued)) {
+            queue = &q;
+            oldest = job;
+        }
+    }
+
+    if (queue == nullptr)
+        return false;
+
+    ++statistics_.dropped_overflow;
+    dropped_.push_back(*oldest);
+    queue->erase(oldest);
+    // wake up the worker to notify the dropped job
+    condition_.notify_one();
+
+    return true;
+}
+
+void JobQueue::notify_dropped_jobs_(std::unique_lock<std::mutex> &lock) {
+    std::vector<Job *> dropped;
+    dropped.swap(dropped_);
+
+    // the handlers of the dropped jobs may lock themselves, so don't call them while being locked
+    lock.unlock();
+    for (auto job : dropped) {
+        job->drop(host_);
         delete job;
     }
+    lock.lock();
 }
 
 }}
@@ -19,18 +19,38 @@
 #ifndef WOINC_UI_JOB_QUEUE_H_
 #define WOINC_UI_JOB_QUEUE_H_
 
+#include <array>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <mutex>
+#include <string>
+#include <vector>
+
+#include <woinc/ui/defs.h>
 
 #include "jobs.h"
 #include "visibility.h"
 
 namespace woinc { namespace ui {
 
+// Jobs are queued per priority and the next job is taken from the queue with the highest priority.
+// Interactive jobs always run first. To prevent the starvation of bulk jobs by status jobs, a job
+// which waited longer than the aging limit of its priority is preferred to all jobs which didn't age yet.
+// The number of queued jobs may be limited, see QueueOverflowPolicy for the behaviour of a full queue.
+// Jobs which waited longer than the staleness limit are dropped instead of being returned by pop().
+// Dropped jobs are notified by the thread calling pop(), therefore push() never calls into a handler.
+// The exceptions are the shutdown, which drops all queued jobs, and the jobs pushed after the shutdown.
 class WOINCUI_LOCAL JobQueue {
     public:
-        JobQueue() = default;
+        struct Statistics {
+            std::size_t rejected = 0;
+            std::size_t dropped_overflow = 0;
+            std::size_t dropped_stale = 0;
+        };
+
+    public:
+        JobQueue(const std::string &host);
         ~JobQueue();
 
         JobQueue(const JobQueue &) = delete;
@@ -38,9 +58,9 @@ class WOINCUI_LOCAL JobQueue {
         JobQueue &operator=(const JobQueue &) = delete;
         JobQueue &operator=(JobQueue &&) = delete;
 
-        // The job queue takes ownership of the job
-        void push_front(Job *job);
-        void push_back(Job *job);
+        // The job queue takes ownership of the job.
+        // Returns false if the job is rejected because the queue is full, the job is deleted in this case.
+        bool push(Job *job);
 
         // Returns the next job to run while blocking if there isn't any job in the queue.
         // If shutdown is triggered, a nullptr will be returned.
@@ -49,17 +69,44 @@ class WOINCUI_LOCAL JobQueue {
 
         void shutdown();
 
+        // a capacity of 0 means unlimited
+        void capacity(std::size_t capacity, QueueOverflowPolicy policy);
+        // a limit of 0 disables dropping stale jobs
+        void staleness_limit(std::chrono::seconds limit);
+
+        Statistics statistics() const;
+
     private:
-        void push_(Job *job, bool front);
+        typedef std::chrono::steady_clock Clock;
+        typedef std::deque<Job *> Queue;
+
+        Queue *next_queue_(const Clock::time_point &now);
+
+        std::size_t size_() const;
+        bool full_() const;
+        bool drop_oldest_periodic_job_();
+
+        void notify_dropped_jobs_(std::unique_lock<std::mutex> &lock);
 
     private:
+        const std::string host_;
+
         bool shutdown_ = false;
 
-        std::mutex lock_;
+        std::size_t capacity_ = 64;
+        QueueOverflowPolicy policy_ = QueueOverflowPolicy::DROP_OLDEST_PERIODIC;
+        std::chrono::seconds staleness_limit_ = std::chrono::seconds::zero();
+
+        Statistics statistics_;
+
+        mutable std::mutex lock_;
         std::condition_variable condition_;
+        std::condition_variable not_full_condition_;
 
-        typedef std::deque<Job *> Queue;
-        Queue jobs_;
+        // one queue per priority, ordered from the highest to the lowest priority
+        std::array<Queue, 3> queues_;
+        // dropped jobs waiting to be notified by pop()
+        std::vector<Job *> dropped_;
 };
 
 }}
@@ -20,6 +20,11 @@
 
 #include <cassert>
 #include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <woinc/trace.h>
 
 namespace wrpc = woinc::rpc;
 
@@ -42,18 +47,85 @@ Error as_error__(wrpc::COMMAND_STATUS status) {
 }
 
 
+// entities without keys aren't diffed
+template<typename ENTITIES>
+void notify_delta_handler__(const std::string &, const HandlerRegistry &, DeltaTracker &, const ENTITIES &) {}
+
+template<typename ENTITIES>
+void notify_keyed_delta_handler__(const std::string &host, const HandlerRegistry &handler_registry,
+                                  DeltaTracker &delta_tracker, const ENTITIES &entities) {
+    // don't keep the last entities if nobody is interested in the deltas
+    if (!handler_registry.has_delta_handler()) {
+        delta_tracker.reset();
+        return;
+    }
+
+    auto delta = delta_tracker.update(entities);
+    if (!delta.empty()) {
+        handler_registry.for_delta_handler([&](auto &handler) {
+            handler.on_delta(host, delta);
+        });
+    }
+}
+
+void notify_delta_handler__(const std::string &host, const HandlerRegistry &handler_registry,
+                            DeltaTracker &delta_tracker, const woinc::FileTransfers &file_transfers) {
+    notify_keyed_delta_handler__(host, handler_registry, delta_tracker, file_transfers);
+}
+
+void notify_delta_handler__(const std::string &host, const HandlerRegistry &handler_registry,
+                            DeltaTracker &delta_tracker, const woinc::Projects &projects) {
+    notify_keyed_delta_handler__(host, handler_registry, delta_tracker, projects);
+}
+
+void notify_delta_handler__(const std::string &host, const HandlerRegistry &handler_registry,
+                            DeltaTracker &delta_tracker, const woinc::Tasks &tasks) {
+    notify_keyed_delta_handler__(host, handler_registry, delta_tracker, tasks);
+}
+
+template<typename ENTITY>
+void publish__(Client &client, const HandlerRegistry &handler_registry,
+               DeltaTracker &delta_tracker, StateCache &state_cache,
+               std::shared_ptr<const ENTITY> entity) {
+    handler_registry.for_periodic_task_handler([&](auto &handler) {
+        handler.on_update(client.host(), entity);
+    });
+    notify_delta_handler__(client.host(), handler_registry, delta_tracker, *entity);
+
+    state_cache.update(std::move(entity));
+}
+
+// returns the published entity or nullptr if the command failed
 template<typename CMD, typename GETTER>
-void execute__(Client &client, const HandlerRegistry &handler_registry, CMD cmd, GETTER getter) {
+auto execute__(Client &client, const HandlerRegistry &handler_registry,
+               DeltaTracker &delta_tracker, StateCache &state_cache,
+               CMD cmd, GETTER getter) {
+    typedef std::remove_reference_t<decltype(getter(cmd.response()))> Data;
+    std::shared_ptr<const Data> entity;
+
     auto status = client.execute(cmd);
     if (status == wrpc::COMMAND_STATUS::OK) {
-        handler_registry.for_periodic_task_handler([&](auto &handler) {
-            handler.on_update(client.host(), getter(cmd.response()));
-        });
+        // move the entity out of the response into the cache, so it's shared instead of copied
+        entity = std::make_shared<Data>(std::move(getter(cmd.response())));
+        publish__(client, handler_registry, delta_tracker, state_cache, entity);
     } else {
         handler_registry.for_host_handler([&](auto &handler) {
             handler.on_host_error(client.host(), as_error__(status));
         });
     }
+
+    return entity;
+}
+
+// the tasks as returned by GET_TASKS
+std::shared_ptr<const woinc::Tasks> tasks__(const woinc::Tasks &tasks, bool active_only) {
+    auto result = std::make_shared<woinc::Tasks>();
+    result->reserve(tasks.size());
+    // copy constructed only, see woinc::Task
+    for (const auto &task : tasks)
+        if (!active_only || task.active_task != nullptr)
+            result->push_back(task);
+    return result;
 }
 
 }
@@ -63,54 +135,81 @@ namespace woinc { namespace ui {
 // ---- Job ----
 
 void Job::operator()(Client &client) {
-    execute(client);
+    client.metrics_recorder().record_queue_wait(std::chrono::steady_clock::now() - enqueued);
+
+    {
+        WOINC_TRACE_SPAN("job.execute");
+        execute(client);
+    }
 
     if (post_handler_)
         post_handler_->handle_post_execution(client.host(), this);
 }
 
+void Job::drop(const std::string &host) {
+    if (post_handler_)
+        post_handler_->handle_dropped(host, this);
+}
+
 void Job::register_post_execution_handler(PostExecutionHandler *handler) {
     post_handler_ = handler;
 }
 
 // ---- PeriodicJob ----
 
-PeriodicJob::PeriodicJob(PeriodicTask t, const HandlerRegistry &hr, const Payload &p)
-    : task(t), handler_registry(hr), payload(p)
+PeriodicJob::PeriodicJob(PeriodicTask t, const HandlerRegistry &hr,
+                         DeltaTracker &dt, StateCache &sc,
+                         const Payload &p)
+    : task(t), handler_registry(hr), delta_tracker(dt), state_cache(sc), payload(p)
 {}
 
 void PeriodicJob::execute(Client &client) {
     switch (task) {
         case PeriodicTask::GET_CCSTATUS:
-            execute__(client, handler_registry,
-                      wrpc::GetCCStatusCommand(),
-                      std::mem_fn(&wrpc::GetCCStatusResponse::cc_status));
+            succeeded = execute__(client, handler_registry, delta_tracker, state_cache,
+                                  wrpc::GetCCStatusCommand(),
+                                  std::mem_fn(&wrpc::GetCCStatusResponse::cc_status)) != nullptr;
             break;
         case PeriodicTask::GET_CLIENT_STATE:
-            execute__(client, handler_registry,
-                      wrpc::GetClientStateCommand(),
-                      std::mem_fn(&wrpc::GetClientStateResponse::client_state));
+            {
+                auto client_state = execute__(client, handler_registry, delta_tracker, state_cache,
+                                              wrpc::GetClientStateCommand(),
+                                              std::mem_fn(&wrpc::GetClientStateResponse::client_state));
+                succeeded = client_state != nullptr;
+
+                // publish the subsumed entities as if they were polled, see subsumed_tasks()
+                if (succeeded) {
+                    publish__(client, handler_registry, delta_tracker, state_cache,
+                              std::shared_ptr<const woinc::Projects>(
+                                  std::make_shared<woinc::Projects>(client_state->projects)));
+                    publish__(client, handler_registry, delta_tracker, state_cache,
+                              tasks__(client_state->tasks, payload.active_only));
+                }
+            }
             break;
         case PeriodicTask::GET_DISK_USAGE:
-            execute__(client, handler_registry,
-                      wrpc::GetDiskUsageCommand(),
-                      std::mem_fn(&wrpc::GetDiskUsageResponse::disk_usage));
+            succeeded = execute__(client, handler_registry, delta_tracker, state_cache,
+                                  wrpc::GetDiskUsageCommand(),
+                                  std::mem_fn(&wrpc::GetDiskUsageResponse::disk_usage)) != nullptr;
             break;
         case PeriodicTask::GET_FILE_TRANSFERS:
-            execute__(client, handler_registry,
-                      wrpc::GetFileTransfersCommand(),
-                      std::mem_fn(&wrpc::GetFileTransfersResponse::file_transfers));
+            succeeded = execute__(client, handler_registry, delta_tracker, state_cache,
+                                  wrpc::GetFileTransfersCommand(),
+                                  std::mem_fn(&wrpc::GetFileTransfersResponse::file_transfers)) != nullptr;
             break;
         case PeriodicTask::GET_MESSAGES:
             {
                 wrpc::GetMessagesCommand cmd;
                 cmd.request().seqno = payload.seqno;
                 auto status = client.execute(cmd);
-                if (status == wrpc::COMMAND_STATUS::OK) {
+                succeeded = status == wrpc::COMMAND_STATUS::OK;
+                if (succeeded) {
                     if (!cmd.response().messages.empty()) {
                         payload.seqno = cmd.response().messages.back().seqno;
+                        std::shared_ptr<const woinc::Messages> messages =
+                            std::make_shared<woinc::Messages>(std::move(cmd.response().messages));
                         handler_registry.for_periodic_task_handler([&](auto &handler) {
-                            handler.on_update(client.host(), cmd.response().messages);
+                            handler.on_update(client.host(), messages);
                         });
                     }
                 } else {
@@ -125,11 +224,14 @@ void PeriodicJob::execute(Client &client) {
                 wrpc::GetNoticesCommand cmd;
                 cmd.request().seqno = payload.seqno;
                 auto status = client.execute(cmd);
-                if (status == wrpc::COMMAND_STATUS::OK) {
+                succeeded = status == wrpc::COMMAND_STATUS::OK;
+                if (succeeded) {
                     if (!cmd.response().notices.empty()) {
                         payload.seqno = cmd.response().notices.back().seqno;
+                        std::shared_ptr<const woinc::Notices> notices =
+                            std::make_shared<woinc::Notices>(std::move(cmd.response().notices));
                         handler_registry.for_periodic_task_handler([&](auto &handler) {
-                            handler.on_update(client.host(), cmd.response().notices, cmd.response().refreshed);
+                            handler.on_update(client.host(), notices, cmd.response().refreshed);
                         });
                     }
                 } else {
@@ -140,14 +242,14 @@ void PeriodicJob::execute(Client &client) {
             }
             break;
         case PeriodicTask::GET_PROJECT_STATUS:
-            execute__(client, handler_registry,
-                      wrpc::GetProjectStatusCommand(),
-                      std::mem_fn(&wrpc::GetProjectStatusResponse::projects));
+            succeeded = execute__(client, handler_registry, delta_tracker, state_cache,
+                                  wrpc::GetProjectStatusCommand(),
+                                  std::mem_fn(&wrpc::GetProjectStatusResponse::projects)) != nullptr;
             break;
         case PeriodicTask::GET_STATISTICS:
-            execute__(client, handler_registry,
-                      wrpc::GetStatisticsCommand(),
-                      std::mem_fn(&wrpc::GetStatisticsResponse::statistics));
+            succeeded = execute__(client, handler_registry, delta_tracker, state_cache,
+                                  wrpc::GetStatisticsCommand(),
+                                  std::mem_fn(&wrpc::GetStatisticsResponse::statistics)) != nullptr;
             break;
         case PeriodicTask::GET_TASKS:
             {
@@ -162,17 +264,45 @@ void PeriodicJob::execute(Client &client) {
 #endif
                 wrpc::GetResultsCommand cmd;
                 cmd.request().active_only = payload.active_only;
-                execute__(client, handler_registry,
-                          std::move(cmd), std::mem_fn(&wrpc::GetResultsResponse::tasks));
+                succeeded = execute__(client, handler_registry, delta_tracker, state_cache,
+                                      std::move(cmd), std::mem_fn(&wrpc::GetResultsResponse::tasks)) != nullptr;
             }
             break;
     }
 }
 
+JobPriority PeriodicJob::priority() const {
+    switch (task) {
+        case PeriodicTask::GET_CCSTATUS:
+        case PeriodicTask::GET_FILE_TRANSFERS:
+        case PeriodicTask::GET_MESSAGES:
+        case PeriodicTask::GET_PROJECT_STATUS:
+        case PeriodicTask::GET_TASKS:
+            return JobPriority::STATUS;
+        case PeriodicTask::GET_CLIENT_STATE:
+        case PeriodicTask::GET_DISK_USAGE:
+        case PeriodicTask::GET_NOTICES:
+        case PeriodicTask::GET_STATISTICS:
+            return JobPriority::BULK;
+    }
+    assert(false);
+    return JobPriority::BULK;
+}
+
+std::vector<PeriodicTask> PeriodicJob::subsumed_tasks(PeriodicTask task) {
+    switch (task) {
+        case PeriodicTask::GET_CLIENT_STATE:
+            return { PeriodicTask::GET_PROJECT_STATUS, PeriodicTask::GET_TASKS };
+        default:
+            return {};
+    }
+}
+
 // ---- AuthorizationJob ----
 
-AuthorizationJob::AuthorizationJob(const std::string &password, const HandlerRegistry &handler_registry)
-    : password_(password), handler_registry_(handler_registry)
+AuthorizationJob::AuthorizationJob(const std::string &password, const HandlerRegistry &handler_registry,
+                                   Callback callback)
+    : password_(password), handler_registry_(handler_registry), callback_(std::move(callback))
 {}
 
 void AuthorizationJob::execute(Client &client) {
@@ -188,6 +318,21 @@ void AuthorizationJob::execute(Client &client) {
         else
             handler.on_host_error(client.host(), as_error__(status));
     });
+
+    if (callback_) {
+        if (status == wrpc::COMMAND_STATUS::OK)
+            callback_(true, "");
+        else if (status == wrpc::COMMAND_STATUS::UNAUTHORIZED)
+            callback_(false, "Authorization failed");
+        else
+            callback_(false, cmd.error().empty() ? "Error while authorizing" : cmd.error());
+    }
+}
+
+void AuthorizationJob::drop(const std::string &host) {
+    if (callback_)
+        callback_(false, "Job dropped by the job queue of host \"" + host + "\"");
+    Job::drop(host);
 }
 
 }}
@@ -19,24 +19,44 @@
 #ifndef WOINC_UI_JOBS_H_
 #define WOINC_UI_JOBS_H_
 
+#include <chrono>
+#include <exception>
+#include <functional>
 #include <future>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <woinc/rpc_command.h>
+#include <woinc/ui/bulk.h>
+#include <woinc/ui/completion.h>
 #include <woinc/ui/defs.h>
 
 #include "client.h"
+#include "delta_tracker.h"
 #include "handler_registry.h"
+#include "state_cache.h"
 #include "visibility.h"
 
 namespace woinc { namespace ui {
 
 struct WOINCUI_LOCAL Job;
 
+// The job queue executes jobs of a higher priority first, see JobQueue for details
+enum class JobPriority {
+    INTERACTIVE, // triggered by the user, e.g. task operations or changing the run mode
+    STATUS,      // cheap periodic polls the user is usually looking at
+    BULK         // expensive or rarely changing periodic polls
+};
+
 struct WOINCUI_LOCAL PostExecutionHandler {
     virtual ~PostExecutionHandler() = default;
     virtual void handle_post_execution(const std::string &host, Job *) = 0;
+    // called instead of handle_post_execution if the job queue dropped the job without executing it
+    virtual void handle_dropped(const std::string &host, Job *) = 0;
 };
 
 struct WOINCUI_LOCAL Job {
@@ -44,10 +64,18 @@ struct WOINCUI_LOCAL Job {
 
     virtual void execute(Client &client) = 0;
 
+    virtual JobPriority priority() const = 0;
+
     void operator()(Client &client);
 
+    // called by the job queue instead of executing the job, e.g. if the job became stale
+    virtual void drop(const std::string &host);
+
     void register_post_execution_handler(PostExecutionHandler *handler);
 
+    // set by the job queue when the job is queued
+    std::chrono::steady_clock::time_point enqueued;
+
     private:
         PostExecutionHandler *post_handler_ = nullptr;
 };
@@ -58,49 +86,204 @@ struct WOINCUI_LOCAL PeriodicJob : public Job {
         int seqno;
     };
 
-    PeriodicJob(PeriodicTask t, const HandlerRegistry &handler_registry, const Payload &payload = Payload());
+    PeriodicJob(PeriodicTask t, const HandlerRegistry &handler_registry,
+                DeltaTracker &delta_tracker, StateCache &state_cache,
+                const Payload &payload = Payload());
     virtual ~PeriodicJob() = default;
 
     void execute(Client &client) final;
 
+    JobPriority priority() const final;
+
+    // The periodic tasks whose entities are part of the response of the given task, e.g. the projects
+    // and tasks of the client state. The job publishes these entities too, so they don't need to be polled
+    // separately after the job succeeded.
+    static std::vector<PeriodicTask> subsumed_tasks(PeriodicTask task);
+
     const PeriodicTask task;
     const HandlerRegistry &handler_registry;
+    DeltaTracker &delta_tracker;
+    StateCache &state_cache;
 
     Payload payload;
+    bool succeeded = false;
 };
 
 struct WOINCUI_LOCAL AuthorizationJob : public Job {
-    AuthorizationJob(const std::string &password, const HandlerRegistry &handler_registry);
+    // called after the handlers were notified, the error is set if the authorization failed
+    typedef std::function<void(bool authorized, std::string error)> Callback;
+
+    AuthorizationJob(const std::string &password, const HandlerRegistry &handler_registry,
+                     Callback callback = Callback());
     virtual ~AuthorizationJob() = default;
 
     void execute(Client &client) final;
 
+    JobPriority priority() const final { return JobPriority::INTERACTIVE; }
+
+    void drop(const std::string &host) final;
+
     private:
         const std::string password_;
         const HandlerRegistry &handler_registry_;
+        Callback callback_;
+};
+
+// The sinks pass the result of a CommandJob to the user, either via a future or a completion
+
+template<typename RESULT>
+struct WOINCUI_LOCAL PromiseSink {
+    std::promise<RESULT> promise;
+
+    void set_value(RESULT value) { promise.set_value(std::move(value)); }
+    void set_error(std::exception_ptr error) { promise.set_exception(std::move(error)); }
 };
 
-// wrap async commands that request data from the client; errors should be propagated through the future by the handler
 template<typename RESULT>
-struct WOINCUI_LOCAL PromisedResultJob : public Job {
-    typedef std::promise<RESULT> Promise;
-    typedef std::function<void(woinc::rpc::Command *cmd,
-                               Promise &promise,
-                               woinc::rpc::COMMAND_STATUS status)> ResultHandler;
+struct WOINCUI_LOCAL CompletionSink {
+    CompletionSink(Completion<RESULT> c, Executor e) : completion(std::move(c)), executor(std::move(e)) {}
+
+    Completion<RESULT> completion;
+    Executor executor;
+
+    void set_value(RESULT value) { complete_(Result<RESULT>(std::move(value))); }
+    void set_error(std::exception_ptr error) { complete_(Result<RESULT>(std::move(error))); }
+
+    private:
+        void complete_(Result<RESULT> result) {
+            if (executor)
+                executor([c = std::move(completion), r = std::move(result)]() mutable { c(std::move(r)); });
+            else
+                completion(std::move(result));
+        }
+};
 
-    // the job takes the ownership of the command
-    PromisedResultJob(woinc::rpc::Command *cmd, Promise promise, ResultHandler handler)
-        : cmd_(cmd), promise_(std::move(promise)), handler_(handler) {}
-    virtual ~PromisedResultJob() = default;
+// wraps async commands triggered by the user; the result or the error is passed to the sink
+template<typename RESULT, typename SINK>
+struct WOINCUI_LOCAL CommandJob : public Job {
+    typedef RESULT (*Extractor)(woinc::rpc::Command &cmd);
+
+    // the job takes the ownership of the command, the error is passed to the sink if the command fails
+    CommandJob(woinc::rpc::Command *cmd, Extractor extractor, const char *error, SINK sink)
+        : cmd_(cmd), extractor_(extractor), error_(error), sink_(std::move(sink)) {}
+    virtual ~CommandJob() = default;
 
     void execute(Client &client) final {
-        handler_(cmd_.get(), promise_, client.execute(*cmd_));
+        if (client.execute(*cmd_) == woinc::rpc::COMMAND_STATUS::OK)
+            sink_.set_value(extractor_(*cmd_));
+        else
+            sink_.set_error(std::make_exception_ptr(std::runtime_error(error_)));
+    }
+
+    JobPriority priority() const final { return JobPriority::INTERACTIVE; }
+
+    void drop(const std::string &host) final {
+        sink_.set_error(std::make_exception_ptr(
+                std::runtime_error("Job dropped by the job queue of host \"" + host + "\"")));
+        Job::drop(host);
     }
 
     private:
         std::unique_ptr<woinc::rpc::Command> cmd_;
-        Promise promise_;
-        ResultHandler handler_;
+        Extractor extractor_;
+        const char *error_;
+        SINK sink_;
+};
+
+// ---- bulk operations ----
+
+// The state shared by the jobs of a bulk operation, the job finishing the last target passes the result to the sink
+template<typename TARGET, typename SINK>
+struct WOINCUI_LOCAL BulkOperation {
+    BulkOperation(std::vector<TARGET> targets, SINK sink, BulkProgress progress, Executor executor);
+
+    const TARGET &target(std::size_t index) const { return result_.results[index].target; }
+
+    // threadsafe, each target has to be finished exactly once
+    void finish(std::size_t index, bool success, std::string error = "");
+
+    private:
+        std::mutex lock_;
+        TargetResults<TARGET> result_;
+        std::size_t processed_ = 0;
+        SINK sink_;
+        BulkProgress progress_;
+        Executor executor_;
+};
+
+template<typename TARGET, typename SINK>
+BulkOperation<TARGET, SINK>::BulkOperation(std::vector<TARGET> targets, SINK sink, BulkProgress progress, Executor executor)
+    : sink_(std::move(sink)), progress_(std::move(progress)), executor_(std::move(executor))
+{
+    result_.results.reserve(targets.size());
+    for (auto &target : targets)
+        result_.results.push_back({std::move(target), false, ""});
+}
+
+template<typename TARGET, typename SINK>
+void BulkOperation<TARGET, SINK>::finish(std::size_t index, bool success, std::string error) {
+    bool finished;
+    std::size_t processed, total;
+
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+
+        auto &result = result_.results.at(index);
+        result.success = success;
+        result.error = std::move(error);
+
+        processed = ++processed_;
+        total = result_.results.size();
+        finished = processed == total;
+
+        // posting while being locked keeps the progress in order
+        if (progress_ && executor_)
+            executor_([progress = progress_, processed, total]() { progress(processed, total); });
+    }
+
+    // the progress is user code, so don't block the jobs of the other hosts while calling it
+    if (progress_ && !executor_)
+        progress_(processed, total);
+
+    // there are no more writers after the last target
+    if (finished)
+        sink_.set_value(std::move(result_));
+}
+
+// Executes the task operation on the targets of a single host. The GUI RPC protocol of BOINC doesn't
+// support pipelining, so the RPCs are sent one after the other on the connection of the host.
+template<typename SINK>
+struct WOINCUI_LOCAL BulkTaskOpJob : public Job {
+    BulkTaskOpJob(TASK_OP op, std::shared_ptr<BulkOperation<TaskTarget, SINK>> operation, std::vector<std::size_t> indices)
+        : op_(op), operation_(std::move(operation)), indices_(std::move(indices)) {}
+    virtual ~BulkTaskOpJob() = default;
+
+    void execute(Client &client) final {
+        for (auto index : indices_) {
+            const auto &target = operation_->target(index);
+            woinc::rpc::TaskOpCommand cmd(woinc::rpc::TaskOpRequest(op_, target.master_url, target.task_name));
+
+            if (client.execute(cmd) != woinc::rpc::COMMAND_STATUS::OK)
+                operation_->finish(index, false, cmd.error().empty() ? "Error while executing task operation" : cmd.error());
+            else if (!cmd.response().success)
+                operation_->finish(index, false, "The client rejected the task operation");
+            else
+                operation_->finish(index, true);
+        }
+    }
+
+    JobPriority priority() const final { return JobPriority::INTERACTIVE; }
+
+    void drop(const std::string &host) final {
+        for (auto index : indices_)
+            operation_->finish(index, false, "Job dropped by the job queue of host \"" + host + "\"");
+        Job::drop(host);
+    }
+
+    private:
+        const TASK_OP op_;
+        std::shared_ptr<BulkOperation<TaskTarget, SINK>> operation_;
+        const std::vector<std::size_t> indices_;
 };
 
 }}
@@ -0,0 +1,107 @@
+/* libui/src/metrics.cc --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#include <woinc/ui/metrics.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace woinc { namespace ui {
+
+void LatencyHistogram::record(std::chrono::nanoseconds duration) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    auto value = static_cast<std::uint64_t>(std::max<decltype(us)>(us, 0));
+
+    counts_[index_(value)]++;
+
+    min_ = count_ == 0 ? value : std::min(min_, value);
+    max_ = std::max(max_, value);
+    sum_ += value;
+    count_++;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+    if (other.count_ == 0)
+        return;
+
+    for (std::size_t i = 0; i < counts_.size(); ++i)
+        counts_[i] += other.counts_[i];
+
+    min_ = count_ == 0 ? other.min_ : std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+    count_ += other.count_;
+}
+
+std::chrono::microseconds LatencyHistogram::min() const {
+    return std::chrono::microseconds(min_);
+}
+
+std::chrono::microseconds LatencyHistogram::max() const {
+    return std::chrono::microseconds(max_);
+}
+
+std::chrono::microseconds LatencyHistogram::mean() const {
+    return std::chrono::microseconds(count_ == 0 ? 0 : sum_ / count_);
+}
+
+std::chrono::microseconds LatencyHistogram::percentile(double percentile) const {
+    if (count_ == 0)
+        return std::chrono::microseconds::zero();
+
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(percentile / 100 * static_cast<double>(count_))));
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= rank)
+            return std::chrono::microseconds(std::min(upper_bound_(i), max_));
+    }
+
+    return max();
+}
+
+// values below 2 * SUB_BUCKETS are mapped to their own buckets, all others to the
+// sub bucket selected by the SUB_BUCKET_BITS bits following the most significant bit
+std::size_t LatencyHistogram::index_(std::uint64_t value) {
+    if (value < 2 * SUB_BUCKETS)
+        return static_cast<std::size_t>(value);
+
+    int msb = 0;
+    for (auto v = value; v > 1; v >>= 1)
+        ++msb;
+
+    if (msb > MAX_MSB)
+        return BUCKETS - 1;
+
+    int shift = msb - SUB_BUCKET_BITS;
+    return static_cast<std::size_t>((shift + 1) * SUB_BUCKETS) + ((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+std::uint64_t LatencyHistogram::upper_bound_(std::size_t index) {
+    if (index < 2 * SUB_BUCKETS)
+        return index;
+
+    auto shift = index / SUB_BUCKETS - 1;
+    auto lower = static_cast<std::uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+    return lower + (std::uint64_t(1) << shift) - 1;
+}
+
+}}
@@ -0,0 +1,88 @@
+/* libui/src/metrics_recorder.cc --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#include "metrics_recorder.h"
+
+#include <utility>
+
+#define WOINC_LOCK_GUARD std::lock_guard<decltype(lock_)> guard(lock_)
+
+namespace woinc { namespace ui {
+
+MetricsRecorder::MetricsRecorder(std::string host, const HandlerRegistry &handler_registry)
+    : host_(std::move(host)), handler_registry_(handler_registry)
+{}
+
+void MetricsRecorder::record_connect(std::chrono::nanoseconds duration, bool success) {
+    {
+        WOINC_LOCK_GUARD;
+        metrics_.connect.record(duration);
+        if (!success)
+            metrics_.connection_errors++;
+    }
+
+    handler_registry_.for_metrics_handler([&](MetricsHandler &handler) {
+        handler.on_connect(host_, duration, success);
+    });
+}
+
+void MetricsRecorder::record_queue_wait(std::chrono::nanoseconds duration) {
+    {
+        WOINC_LOCK_GUARD;
+        metrics_.queue_wait.record(duration);
+    }
+
+    handler_registry_.for_metrics_handler([&](MetricsHandler &handler) {
+        handler.on_queue_wait(host_, duration);
+    });
+}
+
+void MetricsRecorder::record_rpc(const RpcSample &sample) {
+    {
+        WOINC_LOCK_GUARD;
+        auto &command = metrics_.commands[sample.rpc];
+
+        // the phases not reached by a failed RPC would distort the latencies with zero durations
+        if (sample.completed >= RpcPhase::SEND)
+            command.send.record(sample.send);
+        if (sample.completed >= RpcPhase::WAIT)
+            command.wait.record(sample.wait);
+        if (sample.completed >= RpcPhase::RECEIVE)
+            command.receive.record(sample.receive);
+        if (sample.completed >= RpcPhase::PARSE)
+            command.parse.record(sample.parse);
+
+        command.bytes_sent += sample.bytes_sent;
+        command.bytes_received += sample.bytes_received;
+
+        if (!sample.success)
+            command.errors++;
+    }
+
+    handler_registry_.for_metrics_handler([&](MetricsHandler &handler) {
+        handler.on_rpc(host_, sample);
+    });
+}
+
+HostMetrics MetricsRecorder::snapshot() const {
+    WOINC_LOCK_GUARD;
+    return metrics_;
+}
+
+}}
@@ -0,0 +1,57 @@
+/* libui/src/metrics_recorder.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#ifndef WOINC_UI_METRICS_RECORDER_H_
+#define WOINC_UI_METRICS_RECORDER_H_
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include <woinc/ui/metrics.h>
+
+#include "handler_registry.h"
+#include "visibility.h"
+
+namespace woinc { namespace ui {
+
+// Aggregates the measurements of a host and passes them on to the metrics handlers.
+// Recording is done by the threads of the host while the controller takes the snapshots.
+class WOINCUI_LOCAL MetricsRecorder {
+    public:
+        MetricsRecorder(std::string host, const HandlerRegistry &handler_registry);
+
+        void record_connect(std::chrono::nanoseconds duration, bool success);
+        void record_queue_wait(std::chrono::nanoseconds duration);
+        void record_rpc(const RpcSample &sample);
+
+        // the job queue counters aren't known to the recorder
+        HostMetrics snapshot() const;
+
+    private:
+        const std::string host_;
+        const HandlerRegistry &handler_registry_;
+
+        mutable std::mutex lock_;
+        HostMetrics metrics_;
+};
+
+}}
+
+#endif
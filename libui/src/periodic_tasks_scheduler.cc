@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <memory>
 #include <mutex>
 #include <thread>
 
@@ -27,6 +28,8 @@
 #include <iostream>
 #endif
 
+#include <woinc/trace.h>
+
 namespace woinc { namespace ui {
 
 // --- PeriodicTasksSchedulerContext ---
@@ -55,6 +58,8 @@ void PeriodicTasksSchedulerContext::add_host(const std::string &host, HostContro
 
 void PeriodicTasksSchedulerContext::remove_host(const std::string &host) {
     std::lock_guard<decltype(lock_)> guard(lock_);
+    for (const auto &task : tasks_.at(host))
+        subscriptions_ -= task.subscriptions.size();
     tasks_.erase(host);
     host_controllers_.erase(host);
     states_.erase(host);
@@ -72,76 +77,175 @@ void PeriodicTasksSchedulerContext::reschedule_now(const std::string &host, Peri
     }
 }
 
+void PeriodicTasksSchedulerContext::subscribe(const PeriodicTaskHandler *handler, const std::string &host,
+                                              PeriodicTask task, std::chrono::seconds max_staleness) {
+    std::lock_guard<decltype(lock_)> guard(lock_);
+
+    auto &subscriptions = tasks_.at(host).at(static_cast<size_t>(task)).subscriptions;
+    if (subscriptions.find(handler) == subscriptions.end())
+        ++subscriptions_;
+    subscriptions[handler] = max_staleness;
+
+    // the task may be due now
+    condition_.notify_one();
+}
+
+void PeriodicTasksSchedulerContext::unsubscribe(const PeriodicTaskHandler *handler,
+                                                const std::string &host,
+                                                PeriodicTask task) {
+    std::lock_guard<decltype(lock_)> guard(lock_);
+    subscriptions_ -= tasks_.at(host).at(static_cast<size_t>(task)).subscriptions.erase(handler);
+}
+
+void PeriodicTasksSchedulerContext::unsubscribe(const PeriodicTaskHandler *handler, const std::string &host) {
+    std::lock_guard<decltype(lock_)> guard(lock_);
+    for (auto &task : tasks_.at(host))
+        subscriptions_ -= task.subscriptions.erase(handler);
+}
+
+void PeriodicTasksSchedulerContext::unsubscribe(const PeriodicTaskHandler *handler) {
+    std::lock_guard<decltype(lock_)> guard(lock_);
+    for (auto &host_tasks : tasks_)
+        for (auto &task : host_tasks.second)
+            subscriptions_ -= task.subscriptions.erase(handler);
+}
+
 void PeriodicTasksSchedulerContext::trigger_shutdown() {
     std::lock_guard<decltype(lock_)> guard(lock_);
     shutdown_triggered_ = true;
 }
 
-// --- PeriodicTasksScheduler ---
+void PeriodicTasksSchedulerContext::handle_post_execution(const std::string &host, Job *j) {
+    // we schedule and therefore register to periodic tasks only
+    assert(dynamic_cast<PeriodicJob *>(j) != nullptr);
 
-PeriodicTasksScheduler::PeriodicTasksScheduler(PeriodicTasksSchedulerContext &context)
-    : context_(context)
-{}
+    PeriodicJob *job = static_cast<PeriodicJob *>(j);
 
-void PeriodicTasksScheduler::operator()() {
-    using namespace std::chrono_literals;
+    std::lock_guard<decltype(lock_)> guard(lock_);
 
-    std::unique_lock<decltype(context_.lock_)> guard(context_.lock_);
+    // the host may have been removed while the job was executed
+    auto host_tasks = tasks_.find(host);
+    if (host_tasks == tasks_.end())
+        return;
 
-    int cache_counter = 0;
-    Configuration::Intervals intervals;
+    auto &tasks = host_tasks->second;
+    auto task = std::find_if(tasks.begin(), tasks.end(), [&](const auto &t) {
+        return t.type == job->task;
+    });
 
-    while (!context_.shutdown_triggered_) {
-        // update interval cache once a second
-        if (cache_counter == 0)
-            intervals = std::move(context_.configuration_.intervals());
-        cache_counter = (cache_counter + 1) % 5;
-
-        const auto now = std::chrono::steady_clock::now();
-
-        for (auto &host_tasks : context_.tasks_) {
-            if (!context_.configuration_.schedule_periodic_tasks(host_tasks.first))
-                continue;
-            for (auto &task : host_tasks.second)
-                if (!task.pending && should_be_scheduled_(task, intervals, now))
-                    schedule_(host_tasks.first, task);
-        }
+    const auto now = std::chrono::steady_clock::now();
 
-        context_.condition_.wait_for(guard, 200ms);
+    if (task != tasks.end()) {
+        task->last_execution = now;
+        task->pending = false;
+
+        if (job->task == PeriodicTask::GET_MESSAGES)
+            states_.at(host).messages_seqno = job->payload.seqno;
+        else if (job->task == PeriodicTask::GET_NOTICES)
+            states_.at(host).notices_seqno = job->payload.seqno;
+    }
+
+    // the job already published the entities of the subsumed tasks, so they are as fresh as if they were
+    // just polled; pending ones are executed nevertheless to not mess with the queue
+    if (!job->succeeded)
+        return;
+
+    for (auto subsumed : PeriodicJob::subsumed_tasks(job->task)) {
+        auto subsumed_task = std::find_if(tasks.begin(), tasks.end(), [&](const auto &t) {
+            return t.type == subsumed;
+        });
+        if (subsumed_task != tasks.end() && !subsumed_task->pending)
+            subsumed_task->last_execution = now;
     }
 }
 
-void PeriodicTasksScheduler::handle_post_execution(const std::string &host, Job *j) {
-    // we schedule and therefore register to periodic tasks only
+void PeriodicTasksSchedulerContext::handle_dropped(const std::string &host, Job *j) {
     assert(dynamic_cast<PeriodicJob *>(j) != nullptr);
 
     PeriodicJob *job = static_cast<PeriodicJob *>(j);
 
-    std::lock_guard<decltype(context_.lock_)> guard(context_.lock_);
+    std::lock_guard<decltype(lock_)> guard(lock_);
 
-    auto &tasks = context_.tasks_.at(host);
-    auto task = std::find_if(tasks.begin(), tasks.end(), [&](const auto &t) {
+    auto tasks = tasks_.find(host);
+    if (tasks == tasks_.end())
+        return;
+
+    auto task = std::find_if(tasks->second.begin(), tasks->second.end(), [&](const auto &t) {
         return t.type == job->task;
     });
 
-    if (task != tasks.end()) {
+    // don't reschedule the dropped job immediately to not refill the queue of an overloaded host,
+    // instead wait for the next interval as if the job was executed
+    if (task != tasks->second.end()) {
         task->last_execution = std::chrono::steady_clock::now();
         task->pending = false;
+    }
+}
 
-        if (job->task == PeriodicTask::GET_MESSAGES)
-            context_.states_.at(host).messages_seqno = job->payload.seqno;
-        else if (job->task == PeriodicTask::GET_NOTICES)
-            context_.states_.at(host).notices_seqno = job->payload.seqno;
+// --- PeriodicTasksScheduler ---
+
+PeriodicTasksScheduler::PeriodicTasksScheduler(PeriodicTasksSchedulerContext &context)
+    : context_(context)
+{}
+
+void PeriodicTasksScheduler::operator()() {
+    using namespace std::chrono_literals;
+
+    std::unique_lock<decltype(context_.lock_)> guard(context_.lock_);
+
+    std::shared_ptr<const Configuration::Snapshot> configuration;
+
+    woinc::trace::thread_name("periodic tasks scheduler");
+
+    while (!context_.shutdown_triggered_) {
+        {
+            WOINC_TRACE_SPAN("scheduler.wakeup");
+
+            // reload the configuration only if it has been modified
+            if (!configuration || configuration->version != context_.configuration_.version())
+                configuration = context_.configuration_.snapshot();
+
+            const auto now = std::chrono::steady_clock::now();
+
+            for (auto &host_tasks : context_.tasks_) {
+                // the host may be added to the scheduler before being added to the configuration
+                auto host_configuration = configuration->host(host_tasks.first);
+                if (host_configuration == nullptr || !host_configuration->schedule_periodic_tasks)
+                    continue;
+
+                for (auto &task : host_tasks.second)
+                    if (!task.pending && should_be_scheduled_(task, host_configuration->intervals, now))
+                        schedule_(host_tasks.first, *host_configuration, task);
+            }
+        }
+
+        context_.condition_.wait_for(guard, 200ms);
     }
 }
 
 bool PeriodicTasksScheduler::should_be_scheduled_(const PeriodicTasksSchedulerContext::Task &task,
                                                   const Configuration::Intervals &intervals,
                                                   const decltype(PeriodicTasksSchedulerContext::Task::last_execution) &now) const {
-    return now >= task.last_execution + std::chrono::seconds(intervals.at(static_cast<size_t>(task.type)));
+    const auto configured = intervals.at(static_cast<size_t>(task.type));
+
+    // without any subscription, everything is polled at the configured intervals
+    if (context_.subscriptions_ == 0)
+        return now >= task.last_execution + configured;
+
+    // the cc status is polled as a heartbeat even if nobody subscribed to it
+    if (task.subscriptions.empty())
+        return task.type == PeriodicTask::GET_CCSTATUS && now >= task.last_execution + configured;
+
+    auto interval = std::chrono::seconds::max();
+    for (const auto &subscription : task.subscriptions)
+        interval = std::min(interval, subscription.second.count() > 0 ? subscription.second : configured);
+
+    return now >= task.last_execution + interval;
 }
 
-void PeriodicTasksScheduler::schedule_(const std::string &host, PeriodicTasksSchedulerContext::Task &task) {
+void PeriodicTasksScheduler::schedule_(const std::string &host,
+                                       const Configuration::HostConfiguration &host_configuration,
+                                       PeriodicTasksSchedulerContext::Task &task) {
     task.pending = true;
 
     PeriodicJob::Payload payload;
@@ -150,13 +254,20 @@ void PeriodicTasksScheduler::schedule_(const std::string &host, PeriodicTasksSch
         payload.seqno = context_.states_.at(host).messages_seqno;
     else if (task.type == PeriodicTask::GET_NOTICES)
         payload.seqno = context_.states_.at(host).notices_seqno;
-    else if (task.type == PeriodicTask::GET_TASKS)
-        payload.active_only = context_.configuration_.active_only_tasks(host);
+    else if (task.type == PeriodicTask::GET_TASKS || task.type == PeriodicTask::GET_CLIENT_STATE)
+        payload.active_only = host_configuration.active_only_tasks;
 
-    auto job = new PeriodicJob(task.type, context_.handler_registry_, payload);
-    job->register_post_execution_handler(this);
+    auto &host_controller = context_.host_controllers_.at(host);
 
-    context_.host_controllers_.at(host).schedule(job);
+    auto job = new PeriodicJob(task.type, context_.handler_registry_,
+                               host_controller.delta_tracker(), host_controller.state_cache(), payload);
+    job->register_post_execution_handler(&context_);
+
+    // the rejected job is deleted by the job queue, so try again after the next interval
+    if (!host_controller.schedule(job)) {
+        task.pending = false;
+        task.last_execution = std::chrono::steady_clock::now();
+    }
 }
 
 }}
@@ -34,7 +34,9 @@
 
 namespace woinc { namespace ui {
 
-class WOINCUI_LOCAL PeriodicTasksSchedulerContext {
+// The context outlives the scheduler thread, so it handles the executed and dropped periodic jobs,
+// which may still be notified by the job queues of the hosts after the scheduler has been shut down.
+class WOINCUI_LOCAL PeriodicTasksSchedulerContext : public PostExecutionHandler {
     public:
         PeriodicTasksSchedulerContext(const Configuration &config, const HandlerRegistry &hander_registry);
 
@@ -43,8 +45,18 @@ class WOINCUI_LOCAL PeriodicTasksSchedulerContext {
 
         void reschedule_now(const std::string &host, PeriodicTask task);
 
+        void subscribe(const PeriodicTaskHandler *handler, const std::string &host,
+                       PeriodicTask task, std::chrono::seconds max_staleness);
+        void unsubscribe(const PeriodicTaskHandler *handler, const std::string &host, PeriodicTask task);
+        void unsubscribe(const PeriodicTaskHandler *handler, const std::string &host);
+        void unsubscribe(const PeriodicTaskHandler *handler);
+
         void trigger_shutdown();
 
+    public:
+        void handle_post_execution(const std::string &host, Job *job) final;
+        void handle_dropped(const std::string &host, Job *job) final;
+
     private:
         friend class PeriodicTasksScheduler;
 
@@ -62,6 +74,8 @@ class WOINCUI_LOCAL PeriodicTasksSchedulerContext {
             const PeriodicTask type;
             bool pending = false;
             std::chrono::steady_clock::time_point last_execution = std::chrono::steady_clock::time_point::min();
+            // the requested max staleness per subscribed handler, zero means the configured interval
+            std::map<const PeriodicTaskHandler *, std::chrono::seconds> subscriptions;
         };
 
         struct State {
@@ -72,22 +86,23 @@ class WOINCUI_LOCAL PeriodicTasksSchedulerContext {
         std::map<std::string, std::array<Task, 9>> tasks_;
         std::map<std::string, HostController &> host_controllers_;
         std::map<std::string, State> states_;
+
+        // the total number of subscriptions over all hosts
+        size_t subscriptions_ = 0;
 };
 
-class WOINCUI_LOCAL PeriodicTasksScheduler : public PostExecutionHandler {
+class WOINCUI_LOCAL PeriodicTasksScheduler {
     public:
         PeriodicTasksScheduler(PeriodicTasksSchedulerContext &context);
 
         void operator()();
 
-    public:
-        void handle_post_execution(const std::string &host, Job *job) final;
-
     private:
         bool should_be_scheduled_(const PeriodicTasksSchedulerContext::Task &task,
                                   const Configuration::Intervals &intervals,
                                   const decltype(PeriodicTasksSchedulerContext::Task::last_execution) &now) const;
-        void schedule_(const std::string &host, PeriodicTasksSchedulerContext::Task &task);
+        void schedule_(const std::string &host, const Configuration::HostConfiguration &host_configuration,
+                       PeriodicTasksSchedulerContext::Task &task);
 
         PeriodicTasksSchedulerContext &context_;
 };
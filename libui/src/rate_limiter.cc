@@ -0,0 +1,79 @@
+/* libui/src/rate_limiter.cc --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+#include "rate_limiter.h"
+
+#include <algorithm>
+
+#include <woinc/trace.h>
+
+#define WOINC_LOCK_GUARD std::lock_guard<decltype(lock_)> guard(lock_)
+
+namespace woinc { namespace ui {
+
+void RateLimiter::limit(RateLimit limit) {
+    WOINC_LOCK_GUARD;
+
+    limit_ = limit;
+    // start with a full bucket
+    tokens_ = limit_.burst;
+    last_refill_ = Clock::now();
+
+    // waiting threads have to recalculate their waiting time
+    condition_.notify_all();
+}
+
+RateLimit RateLimiter::limit() const {
+    WOINC_LOCK_GUARD;
+    return limit_;
+}
+
+bool RateLimiter::acquire() {
+    std::unique_lock<decltype(lock_)> guard(lock_);
+
+    while (!shutdown_) {
+        if (limit_.requests_per_second <= 0)
+            return true;
+
+        refill_(Clock::now());
+
+        if (tokens_ >= 1) {
+            tokens_ -= 1;
+            return true;
+        }
+
+        WOINC_TRACE_SPAN("rate_limiter.wait");
+        condition_.wait_for(guard, std::chrono::duration<double>((1 - tokens_) / limit_.requests_per_second));
+    }
+
+    return false;
+}
+
+void RateLimiter::shutdown() {
+    WOINC_LOCK_GUARD;
+    shutdown_ = true;
+    condition_.notify_all();
+}
+
+void RateLimiter::refill_(Clock::time_point now) {
+    const std::chrono::duration<double> elapsed = now - last_refill_;
+    tokens_ = std::min(static_cast<double>(limit_.burst), tokens_ + elapsed.count() * limit_.requests_per_second);
+    last_refill_ = now;
+}
+
+}}
@@ -0,0 +1,62 @@
+/* libui/src/rate_limiter.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef WOINC_UI_RATE_LIMITER_H_
+#define WOINC_UI_RATE_LIMITER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#include <woinc/ui/defs.h>
+
+#include "visibility.h"
+
+namespace woinc { namespace ui {
+
+// A token bucket limiting the RPCs sent to a host. The bucket holds up to burst tokens and
+// is refilled with requests_per_second tokens per second, each RPC takes one token.
+class WOINCUI_LOCAL RateLimiter {
+    public:
+        void limit(RateLimit limit);
+        RateLimit limit() const;
+
+        // Blocks until a token is available.
+        // Returns false without taking a token if the limiter is shut down.
+        bool acquire();
+
+        void shutdown();
+
+    private:
+        typedef std::chrono::steady_clock Clock;
+
+        void refill_(Clock::time_point now);
+
+    private:
+        mutable std::mutex lock_;
+        std::condition_variable condition_;
+
+        RateLimit limit_;
+        double tokens_ = 0;
+        Clock::time_point last_refill_ = Clock::now();
+        bool shutdown_ = false;
+};
+
+}}
+
+#endif
@@ -0,0 +1,75 @@
+/* libui/src/state_cache.cc --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+#include "state_cache.h"
+
+#include <utility>
+
+#define WOINC_LOCK_GUARD std::lock_guard<decltype(lock_)> guard(lock_)
+
+namespace woinc { namespace ui {
+
+void StateCache::update(std::shared_ptr<const woinc::CCStatus> cc_status) {
+    update_(state_.cc_status, std::move(cc_status), Entity::CC_STATUS);
+}
+
+void StateCache::update(std::shared_ptr<const woinc::ClientState> client_state) {
+    update_(state_.client_state, std::move(client_state), Entity::CLIENT_STATE);
+}
+
+void StateCache::update(std::shared_ptr<const woinc::DiskUsage> disk_usage) {
+    update_(state_.disk_usage, std::move(disk_usage), Entity::DISK_USAGE);
+}
+
+void StateCache::update(std::shared_ptr<const woinc::FileTransfers> file_transfers) {
+    update_(state_.file_transfers, std::move(file_transfers), Entity::FILE_TRANSFERS);
+}
+
+void StateCache::update(std::shared_ptr<const woinc::Projects> projects) {
+    update_(state_.projects, std::move(projects), Entity::PROJECTS);
+}
+
+void StateCache::update(std::shared_ptr<const woinc::Statistics> statistics) {
+    update_(state_.statistics, std::move(statistics), Entity::STATISTICS);
+}
+
+void StateCache::update(std::shared_ptr<const woinc::Tasks> tasks) {
+    update_(state_.tasks, std::move(tasks), Entity::TASKS);
+}
+
+HostState StateCache::snapshot() const {
+    WOINC_LOCK_GUARD;
+    return state_;
+}
+
+std::uint64_t StateCache::version(Entity entity) const {
+    WOINC_LOCK_GUARD;
+    return state_.version(entity);
+}
+
+template<typename T>
+void StateCache::update_(std::shared_ptr<const T> &dest, std::shared_ptr<const T> src, Entity entity) {
+    // the old entity may be the last reference, so destroy it after unlocking
+    {
+        WOINC_LOCK_GUARD;
+        dest.swap(src);
+        ++state_.versions.at(static_cast<size_t>(entity));
+    }
+}
+
+}}
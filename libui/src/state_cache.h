@@ -0,0 +1,59 @@
+/* libui/src/state_cache.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef WOINC_UI_STATE_CACHE_H_
+#define WOINC_UI_STATE_CACHE_H_
+
+#include <memory>
+#include <mutex>
+
+#include <woinc/types.h>
+#include <woinc/ui/defs.h>
+#include <woinc/ui/state.h>
+
+#include "visibility.h"
+
+namespace woinc { namespace ui {
+
+// Keeps the last received entities of a host. Updated by the worker thread of the host
+// while the snapshots may be taken by any thread.
+class WOINCUI_LOCAL StateCache {
+    public:
+        void update(std::shared_ptr<const woinc::CCStatus> cc_status);
+        void update(std::shared_ptr<const woinc::ClientState> client_state);
+        void update(std::shared_ptr<const woinc::DiskUsage> disk_usage);
+        void update(std::shared_ptr<const woinc::FileTransfers> file_transfers);
+        void update(std::shared_ptr<const woinc::Projects> projects);
+        void update(std::shared_ptr<const woinc::Statistics> statistics);
+        void update(std::shared_ptr<const woinc::Tasks> tasks);
+
+        HostState snapshot() const;
+        std::uint64_t version(Entity entity) const;
+
+    private:
+        template<typename T>
+        void update_(std::shared_ptr<const T> &dest, std::shared_ptr<const T> src, Entity entity);
+
+    private:
+        mutable std::mutex lock_;
+        HostState state_;
+};
+
+}}
+
+#endif
@@ -18,6 +18,10 @@
 
 #include "qt/adapter.h"
 
+#include <utility>
+
+#include <QTimer>
+
 #include <woinc/ui/handler.h>
 
 namespace woinc { namespace ui { namespace qt {
@@ -29,6 +33,11 @@ void HandlerAdapter::on_host_added(const std::string &host) {
 }
 
 void HandlerAdapter::on_host_removed(const std::string &host) {
+    // libui doesn't call any handler for the host afterwards, so pending updates would be for an unknown host
+    {
+        std::lock_guard<decltype(lock_)> guard(lock_);
+        mailboxes_.erase(host);
+    }
     emit removed(QString::fromStdString(host));
 }
 
@@ -48,40 +57,95 @@ void HandlerAdapter::on_host_error(const std::string &host, Error error) {
     emit error_occurred(QString::fromStdString(host), error);
 }
 
-void HandlerAdapter::on_update(const std::string &host, const woinc::CCStatus &value) {
-    emit updated_cc_status(QString::fromStdString(host), value);
+void HandlerAdapter::on_update(const std::string &host, std::shared_ptr<const woinc::CCStatus> value) {
+    post_(host, [&](Mailbox &mailbox) { mailbox.cc_status = std::move(value); });
+}
+
+void HandlerAdapter::on_update(const std::string &host, std::shared_ptr<const woinc::ClientState> value) {
+    post_(host, [&](Mailbox &mailbox) { mailbox.client_state = std::move(value); });
 }
 
-void HandlerAdapter::on_update(const std::string &host, const woinc::ClientState &value) {
-    emit updated_client_state(QString::fromStdString(host), value);
+void HandlerAdapter::on_update(const std::string &host, std::shared_ptr<const woinc::DiskUsage> value) {
+    post_(host, [&](Mailbox &mailbox) { mailbox.disk_usage = std::move(value); });
 }
 
-void HandlerAdapter::on_update(const std::string &host, const woinc::DiskUsage &value) {
-    emit updated_disk_usage(QString::fromStdString(host), value);
+void HandlerAdapter::on_update(const std::string &host, std::shared_ptr<const woinc::FileTransfers> value) {
+    post_(host, [&](Mailbox &mailbox) { mailbox.file_transfers = std::move(value); });
 }
 
-void HandlerAdapter::on_update(const std::string &host, const woinc::FileTransfers &value) {
-    emit updated_file_transfers(QString::fromStdString(host), value);
+void HandlerAdapter::on_update(const std::string &host, std::shared_ptr<const woinc::Notices> notices, bool refreshed) {
+    post_(host, [&](Mailbox &mailbox) {
+        // refreshed notices replace all previous ones, including the pending ones
+        if (refreshed)
+            mailbox.notices.clear();
+        mailbox.notices.emplace_back(std::move(notices), refreshed);
+    });
 }
 
-void HandlerAdapter::on_update(const std::string &host, const woinc::Notices &notices, bool refreshed) {
-    emit updated_notices(QString::fromStdString(host), notices, refreshed);
+void HandlerAdapter::on_update(const std::string &host, std::shared_ptr<const woinc::Messages> value) {
+    post_(host, [&](Mailbox &mailbox) { mailbox.messages.push_back(std::move(value)); });
 }
 
-void HandlerAdapter::on_update(const std::string &host, const woinc::Messages &value) {
-    emit updated_messages(QString::fromStdString(host), value);
+void HandlerAdapter::on_update(const std::string &host, std::shared_ptr<const woinc::Projects> value) {
+    post_(host, [&](Mailbox &mailbox) { mailbox.projects = std::move(value); });
 }
 
-void HandlerAdapter::on_update(const std::string &host, const woinc::Projects &value) {
-    emit updated_projects(QString::fromStdString(host), value);
+void HandlerAdapter::on_update(const std::string &host, std::shared_ptr<const woinc::Statistics> value) {
+    post_(host, [&](Mailbox &mailbox) { mailbox.statistics = std::move(value); });
 }
 
-void HandlerAdapter::on_update(const std::string &host, const woinc::Statistics &value) {
-    emit updated_statistics(QString::fromStdString(host), value);
+void HandlerAdapter::on_update(const std::string &host, std::shared_ptr<const woinc::Tasks> value) {
+    post_(host, [&](Mailbox &mailbox) { mailbox.tasks = std::move(value); });
+}
+
+template<typename FUNC>
+void HandlerAdapter::post_(const std::string &host, FUNC func) {
+    std::lock_guard<decltype(lock_)> guard(lock_);
+
+    func(mailboxes_[host]);
+
+    // at most one drain is pending, everything posted until it runs is drained at once
+    if (!drain_scheduled_) {
+        drain_scheduled_ = true;
+        // singleShot with a timeout of 0 posts the call into the event loop of the adapter, so it's threadsafe
+        QTimer::singleShot(0, this, [this]() { drain_(); });
+    }
 }
 
-void HandlerAdapter::on_update(const std::string &host, const woinc::Tasks &value) {
-    emit updated_tasks(QString::fromStdString(host), value);
+void HandlerAdapter::drain_() {
+    decltype(mailboxes_) mailboxes;
+
+    {
+        std::lock_guard<decltype(lock_)> guard(lock_);
+        mailboxes.swap(mailboxes_);
+        drain_scheduled_ = false;
+    }
+
+    for (auto &entry : mailboxes) {
+        const auto host = QString::fromStdString(entry.first);
+        auto &mailbox = entry.second;
+
+        // the client state first, because the tasks are mapped using its apps and workunits
+        if (mailbox.cc_status)
+            emit updated_cc_status(host, std::move(mailbox.cc_status));
+        if (mailbox.client_state)
+            emit updated_client_state(host, std::move(mailbox.client_state));
+        if (mailbox.disk_usage)
+            emit updated_disk_usage(host, std::move(mailbox.disk_usage));
+        if (mailbox.file_transfers)
+            emit updated_file_transfers(host, std::move(mailbox.file_transfers));
+        if (mailbox.projects)
+            emit updated_projects(host, std::move(mailbox.projects));
+        if (mailbox.statistics)
+            emit updated_statistics(host, std::move(mailbox.statistics));
+        if (mailbox.tasks)
+            emit updated_tasks(host, std::move(mailbox.tasks));
+
+        for (auto &messages : mailbox.messages)
+            emit updated_messages(host, std::move(messages));
+        for (auto &notices : mailbox.notices)
+            emit updated_notices(host, std::move(notices.first), notices.second);
+    }
 }
 
 }}}
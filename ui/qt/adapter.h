@@ -19,6 +19,13 @@
 #ifndef WOINC_UI_QT_HANDLER_ADAPTER
 #define WOINC_UI_QT_HANDLER_ADAPTER
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <QMetaType>
 #include <QObject>
 #include <QString>
@@ -27,18 +34,26 @@
 
 Q_DECLARE_METATYPE(woinc::ui::Error)
 
-Q_DECLARE_METATYPE(woinc::CCStatus)
-Q_DECLARE_METATYPE(woinc::ClientState)
-Q_DECLARE_METATYPE(woinc::DiskUsage)
-Q_DECLARE_METATYPE(woinc::FileTransfers)
-Q_DECLARE_METATYPE(woinc::Notices)
-Q_DECLARE_METATYPE(woinc::Messages)
-Q_DECLARE_METATYPE(woinc::Projects)
-Q_DECLARE_METATYPE(woinc::Statistics)
-Q_DECLARE_METATYPE(woinc::Tasks)
+Q_DECLARE_METATYPE(std::shared_ptr<const woinc::CCStatus>)
+Q_DECLARE_METATYPE(std::shared_ptr<const woinc::ClientState>)
+Q_DECLARE_METATYPE(std::shared_ptr<const woinc::DiskUsage>)
+Q_DECLARE_METATYPE(std::shared_ptr<const woinc::FileTransfers>)
+Q_DECLARE_METATYPE(std::shared_ptr<const woinc::Notices>)
+Q_DECLARE_METATYPE(std::shared_ptr<const woinc::Messages>)
+Q_DECLARE_METATYPE(std::shared_ptr<const woinc::Projects>)
+Q_DECLARE_METATYPE(std::shared_ptr<const woinc::Statistics>)
+Q_DECLARE_METATYPE(std::shared_ptr<const woinc::Tasks>)
 
 namespace woinc { namespace ui { namespace qt {
 
+/*
+ * Forwards the callbacks of libui as signals into the thread of the adapter.
+ *
+ * The updates are not queued one by one but put into a mailbox per host, in which a newer update
+ * replaces a pending one of the same entity. The mailboxes are drained in the thread of the adapter,
+ * so a stalled GUI thread applies only the latest update of each entity once it becomes responsive again.
+ * Messages and notices are appended instead, because they are delivered incrementally.
+ */
 class HandlerAdapter : public QObject, public woinc::ui::HostHandler, public woinc::ui::PeriodicTaskHandler {
     Q_OBJECT
 
@@ -57,15 +72,15 @@ class HandlerAdapter : public QObject, public woinc::ui::HostHandler, public woi
         void on_host_error(const std::string &host, Error error) final;
 
     public: // PeriodicTaskHandler
-        void on_update(const std::string &host, const woinc::CCStatus &cc_status) final;
-        void on_update(const std::string &host, const woinc::ClientState &client_state) final;
-        void on_update(const std::string &host, const woinc::DiskUsage &disk_usage) final;
-        void on_update(const std::string &host, const woinc::FileTransfers &file_transfers) final;
-        void on_update(const std::string &host, const woinc::Notices &notices, bool refreshed) final;
-        void on_update(const std::string &host, const woinc::Messages &messages) final;
-        void on_update(const std::string &host, const woinc::Projects &projects) final;
-        void on_update(const std::string &host, const woinc::Statistics &statistics) final;
-        void on_update(const std::string &host, const woinc::Tasks &tasks) final;
+        void on_update(const std::string &host, std::shared_ptr<const woinc::CCStatus> cc_status) final;
+        void on_update(const std::string &host, std::shared_ptr<const woinc::ClientState> client_state) final;
+        void on_update(const std::string &host, std::shared_ptr<const woinc::DiskUsage> disk_usage) final;
+        void on_update(const std::string &host, std::shared_ptr<const woinc::FileTransfers> file_transfers) final;
+        void on_update(const std::string &host, std::shared_ptr<const woinc::Notices> notices, bool refreshed) final;
+        void on_update(const std::string &host, std::shared_ptr<const woinc::Messages> messages) final;
+        void on_update(const std::string &host, std::shared_ptr<const woinc::Projects> projects) final;
+        void on_update(const std::string &host, std::shared_ptr<const woinc::Statistics> statistics) final;
+        void on_update(const std::string &host, std::shared_ptr<const woinc::Tasks> tasks) final;
 
     signals:
         void added(QString host);
@@ -78,15 +93,38 @@ class HandlerAdapter : public QObject, public woinc::ui::HostHandler, public woi
 
         void error_occurred(QString host, woinc::ui::Error error);
 
-        void updated_cc_status(QString host, woinc::CCStatus cc_status);
-        void updated_client_state(QString host, woinc::ClientState client_state);
-        void updated_disk_usage(QString host, woinc::DiskUsage disk_usage);
-        void updated_file_transfers(QString host, woinc::FileTransfers file_transfers);
-        void updated_notices(QString host, woinc::Notices notices, bool refreshed);
-        void updated_messages(QString host, woinc::Messages messages);
-        void updated_projects(QString host, woinc::Projects projects);
-        void updated_statistics(QString host, woinc::Statistics statistics);
-        void updated_tasks(QString host, woinc::Tasks tasks);
+        void updated_cc_status(QString host, std::shared_ptr<const woinc::CCStatus> cc_status);
+        void updated_client_state(QString host, std::shared_ptr<const woinc::ClientState> client_state);
+        void updated_disk_usage(QString host, std::shared_ptr<const woinc::DiskUsage> disk_usage);
+        void updated_file_transfers(QString host, std::shared_ptr<const woinc::FileTransfers> file_transfers);
+        void updated_notices(QString host, std::shared_ptr<const woinc::Notices> notices, bool refreshed);
+        void updated_messages(QString host, std::shared_ptr<const woinc::Messages> messages);
+        void updated_projects(QString host, std::shared_ptr<const woinc::Projects> projects);
+        void updated_statistics(QString host, std::shared_ptr<const woinc::Statistics> statistics);
+        void updated_tasks(QString host, std::shared_ptr<const woinc::Tasks> tasks);
+
+    private:
+        struct Mailbox {
+            std::shared_ptr<const woinc::CCStatus> cc_status;
+            std::shared_ptr<const woinc::ClientState> client_state;
+            std::shared_ptr<const woinc::DiskUsage> disk_usage;
+            std::shared_ptr<const woinc::FileTransfers> file_transfers;
+            std::shared_ptr<const woinc::Projects> projects;
+            std::shared_ptr<const woinc::Statistics> statistics;
+            std::shared_ptr<const woinc::Tasks> tasks;
+
+            std::vector<std::shared_ptr<const woinc::Messages>> messages;
+            std::vector<std::pair<std::shared_ptr<const woinc::Notices>, bool>> notices;
+        };
+
+        template<typename FUNC>
+        void post_(const std::string &host, FUNC func);
+        void drain_();
+
+    private:
+        std::mutex lock_;
+        std::map<std::string, Mailbox> mailboxes_;
+        bool drain_scheduled_ = false;
 };
 
 }}}
@@ -19,8 +19,13 @@
 #include "qt/controller.h"
 
 #include <algorithm>
+#include <exception>
+
+#include <QPointer>
+#include <QTimer>
 
 #include <woinc/ui/controller.h>
+#include <woinc/ui/inventory.h>
 
 #include "qt/adapter.h"
 
@@ -53,18 +58,29 @@ void Controller::deregister_handler(PeriodicTaskHandler *handler){
 }
 
 
-std::future<GlobalPreferences> Controller::load_global_prefs(const QString &host, GET_GLOBAL_PREFS_MODE mode) {
-    return ctrl_->load_global_preferences(host.toStdString(), mode);
+void Controller::load_global_prefs(const QString &host, GET_GLOBAL_PREFS_MODE mode,
+                                   QObject *context, Completion<GlobalPreferences> completion) {
+    ctrl_->load_global_preferences(host.toStdString(), mode, std::move(completion), executor_(context));
 }
 
-std::future<bool> Controller::save_global_prefs(const QString &host,
-                                                const GlobalPreferences &prefs,
-                                                const GlobalPreferencesMask &mask) {
-    return ctrl_->save_global_preferences(host.toStdString(), prefs, mask);
+void Controller::save_global_prefs(const QString &host,
+                                   const GlobalPreferences &prefs,
+                                   const GlobalPreferencesMask &mask,
+                                   QObject *context, Completion<bool> completion) {
+    ctrl_->save_global_preferences(host.toStdString(), prefs, mask, std::move(completion), executor_(context));
 }
 
-std::future<bool> Controller::read_global_prefs(const QString &host) {
-    return ctrl_->read_global_prefs_override(host.toStdString());
+void Controller::read_global_prefs(const QString &host) {
+    ctrl_->read_global_prefs_override(host.toStdString(), report_error_(), executor_(this));
+}
+
+void Controller::add_hosts(QString inventory) {
+    try {
+        ctrl_->add_hosts(load_inventory(inventory.toStdString()),
+                         report_failed_targets_<HostTarget>("hosts"), executor_(this));
+    } catch (const std::exception &e) {
+        emit error_occurred(QString::fromUtf8("Error"), QString::fromUtf8(e.what()));
+    }
 }
 
 void Controller::add_host(QString host, QString url, unsigned short port, QString password) {
@@ -89,27 +105,38 @@ void Controller::do_active_only_tasks(QString host, bool value) {
 }
 
 void Controller::do_file_transfer_op(QString host, FILE_TRANSFER_OP op, QString project_url, QString filename) {
-    ctrl_->file_transfer_op(host.toStdString(), op, project_url.toStdString(), filename.toStdString());
+    ctrl_->file_transfer_op(host.toStdString(), op, project_url.toStdString(), filename.toStdString(),
+                            report_error_(), executor_(this));
 }
 
 void Controller::do_project_op(QString host, QString project_url, PROJECT_OP op) {
-    ctrl_->project_op(host.toStdString(), op, project_url.toStdString());
+    ctrl_->project_op(host.toStdString(), op, project_url.toStdString(), report_error_(), executor_(this));
 }
 
-void Controller::do_task_op(QString host, QString project_url, QString name, TASK_OP op) {
-    ctrl_->task_op(host.toStdString(), op, project_url.toStdString(), name.toStdString());
+void Controller::do_task_op(Tasks tasks, TASK_OP op) {
+    std::vector<TaskTarget> targets;
+    targets.reserve(tasks.size());
+    for (const auto &task : tasks)
+        targets.push_back({task.host.toStdString(), task.project_url.toStdString(), task.task_name.toStdString()});
+
+    try {
+        ctrl_->bulk_task_op(op, std::move(targets), report_failed_targets_<TaskTarget>("task operations"),
+                            executor_(this));
+    } catch (const std::exception &e) {
+        emit error_occurred(QString::fromUtf8("Error"), QString::fromUtf8(e.what()));
+    }
 }
 
 void Controller::set_gpu_mode(QString host, RUN_MODE mode) {
-    ctrl_->gpu_mode(host.toStdString(), mode);
+    ctrl_->gpu_mode(host.toStdString(), mode, report_error_(), executor_(this));
 }
 
 void Controller::set_network_mode(QString host, RUN_MODE mode) {
-    ctrl_->network_mode(host.toStdString(), mode);
+    ctrl_->network_mode(host.toStdString(), mode, report_error_(), executor_(this));
 }
 
 void Controller::set_run_mode(QString host, RUN_MODE mode) {
-    ctrl_->run_mode(host.toStdString(), mode);
+    ctrl_->run_mode(host.toStdString(), mode, report_error_(), executor_(this));
 }
 
 void Controller::schedule_disk_usage_update(QString host) {
@@ -132,7 +159,40 @@ void Controller::schedule_statistics_update(QString host) {
     ctrl_->reschedule_now(host.toStdString(), PeriodicTask::GET_STATISTICS);
 }
 
-void Controller::connect(const HandlerAdapter *adapter) const {
+void Controller::subscribe_host(QString host) {
+    if (subscriber_ == nullptr)
+        return;
+
+    try {
+        for (auto task : { PeriodicTask::GET_CCSTATUS,
+                           PeriodicTask::GET_CLIENT_STATE,
+                           PeriodicTask::GET_DISK_USAGE,
+                           PeriodicTask::GET_FILE_TRANSFERS,
+                           PeriodicTask::GET_MESSAGES,
+                           PeriodicTask::GET_NOTICES,
+                           PeriodicTask::GET_PROJECT_STATUS,
+                           PeriodicTask::GET_STATISTICS,
+                           PeriodicTask::GET_TASKS })
+            ctrl_->subscribe(subscriber_, host.toStdString(), task);
+    } catch (const UnknownHostException &) {
+        // the host has been removed in the meantime
+    }
+}
+
+void Controller::unsubscribe_host(QString host) {
+    if (subscriber_ == nullptr)
+        return;
+
+    try {
+        ctrl_->unsubscribe(subscriber_, host.toStdString());
+    } catch (const UnknownHostException &) {
+        // the host has been removed in the meantime
+    }
+}
+
+void Controller::connect(const HandlerAdapter *adapter) {
+    subscriber_ = adapter;
+
 #define WOINC_CONNECT(FROM, TO) QObject::connect(adapter, &HandlerAdapter::FROM, \
                                                  this, &Controller::TO, \
                                                  Qt::QueuedConnection)
@@ -150,10 +210,8 @@ void Controller::handle_host_connected(QString host) {
         return t.first == host;
     });
 
-    bool auth = credentials != pending_logins_.end();
-    assert(auth);
-
-    if (auth)
+    // hosts without pending credentials were added by add_hosts() and are authorized by the controller
+    if (credentials != pending_logins_.end())
         ctrl_->authorize_host(credentials->first.toStdString(), credentials->second.toStdString());
 }
 
@@ -205,4 +263,48 @@ void Controller::handle_host_error(QString host, Error error) {
     ctrl_->async_remove_host(host.toStdString());
 }
 
+Executor Controller::executor_(QObject *context) {
+    QPointer<QObject> guard(context);
+    return [this, guard](std::function<void()> func) {
+        // singleShot with a timeout of 0 posts the call into the event loop of the controller, so it's threadsafe
+        QTimer::singleShot(0, this, [guard, func = std::move(func)]() {
+            if (guard)
+                func();
+        });
+    };
+}
+
+template<typename TARGET>
+Completion<TargetResults<TARGET>> Controller::report_failed_targets_(const char *what) {
+    return [this, what](Result<TargetResults<TARGET>> result) {
+        try {
+            const auto &results = result.value();
+            auto failed = results.failed();
+            if (failed == 0)
+                return;
+
+            auto first_failed = std::find_if(results.results.begin(), results.results.end(),
+                                             [](const TargetResult<TARGET> &r) { return !r.success; });
+            emit error_occurred(QString::fromUtf8("Error"),
+                                QString::fromUtf8("%1 of %2 %3 failed: %4")
+                                .arg(failed)
+                                .arg(results.results.size())
+                                .arg(QString::fromUtf8(what))
+                                .arg(QString::fromStdString(first_failed->error)));
+        } catch (const std::exception &e) {
+            emit error_occurred(QString::fromUtf8("Error"), QString::fromUtf8(e.what()));
+        }
+    };
+}
+
+Completion<bool> Controller::report_error_() {
+    return [this](Result<bool> result) {
+        try {
+            result.value();
+        } catch (const std::exception &e) {
+            emit error_occurred(QString::fromUtf8("Error"), QString::fromUtf8(e.what()));
+        }
+    };
+}
+
 }}}
@@ -19,7 +19,6 @@
 #ifndef WOINC_UI_QT_CONTROLLER_H_
 #define WOINC_UI_QT_CONTROLLER_H_
 
-#include <future>
 #include <memory>
 #include <mutex>
 #include <utility>
@@ -29,9 +28,13 @@
 #include <QString>
 
 #include <woinc/types.h>
+#include <woinc/ui/bulk.h>
+#include <woinc/ui/completion.h>
 #include <woinc/ui/defs.h>
 #include <woinc/ui/handler.h>
 
+#include "qt/types.h"
+
 namespace woinc { namespace ui {
 
 struct Controller;
@@ -67,14 +70,19 @@ class Controller : public QObject {
         void register_handler(PeriodicTaskHandler *handler);
         void deregister_handler(PeriodicTaskHandler *handler);
 
-        std::future<GlobalPreferences> load_global_prefs(const QString &host, GET_GLOBAL_PREFS_MODE mode);
-        std::future<bool> save_global_prefs(const QString &host,
-                                            const GlobalPreferences &prefs,
-                                            const GlobalPreferencesMask &mask);
-        std::future<bool> read_global_prefs(const QString &host);
+        // the completions are called in the thread of the controller, but not if the context has been destroyed
+        void load_global_prefs(const QString &host, GET_GLOBAL_PREFS_MODE mode,
+                               QObject *context, Completion<GlobalPreferences> completion);
+        void save_global_prefs(const QString &host,
+                               const GlobalPreferences &prefs,
+                               const GlobalPreferencesMask &mask,
+                               QObject *context, Completion<bool> completion);
+        void read_global_prefs(const QString &host);
 
         // TODO wording: do we add a host or a client?
         void add_host(QString host, QString url, unsigned short port, QString password);
+        // adds the hosts of the inventory file, see woinc/ui/inventory.h
+        void add_hosts(QString inventory);
 
     public slots:
         void trigger_shutdown();
@@ -82,7 +90,7 @@ class Controller : public QObject {
         void do_active_only_tasks(QString host, bool value);
         void do_file_transfer_op(QString host, FILE_TRANSFER_OP op, QString project_url, QString filename);
         void do_project_op(QString host, QString project_url, PROJECT_OP op);
-        void do_task_op(QString host, QString project_url, QString name, TASK_OP op);
+        void do_task_op(Tasks tasks, TASK_OP op);
 
         void set_gpu_mode(QString host, RUN_MODE mode);
         void set_network_mode(QString host, RUN_MODE mode);
@@ -94,8 +102,12 @@ class Controller : public QObject {
         void schedule_statistics_update(QString host);
         void schedule_tasks_update(QString host);
 
+        // poll all entities of the host only while it's selected
+        void subscribe_host(QString host);
+        void unsubscribe_host(QString host);
+
     public:
-        void connect(const HandlerAdapter *adapter) const;
+        void connect(const HandlerAdapter *adapter);
 
     private slots:
         void handle_host_connected(QString host);
@@ -103,8 +115,18 @@ class Controller : public QObject {
         void handle_host_authorization_failed(QString host);
         void handle_host_error(QString host, Error error);
 
+    private:
+        // runs the completions of the commands in the thread of the controller
+        Executor executor_(QObject *context);
+        // emits error_occurred if the command failed
+        Completion<bool> report_error_();
+        // emits error_occurred if any target of the bulk operation failed
+        template<typename TARGET>
+        Completion<TargetResults<TARGET>> report_failed_targets_(const char *what);
+
     private:
         std::unique_ptr<woinc::ui::Controller> ctrl_;
+        const PeriodicTaskHandler *subscriber_ = nullptr;
         std::mutex lock_;
         std::vector<std::pair<QString, QString>> pending_logins_;
 };
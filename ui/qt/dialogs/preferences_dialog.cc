@@ -729,16 +729,19 @@ void PreferencesDialog::save() {
     QString error;
 
     try {
-        auto future = controller_.save_global_prefs("localhost", prefs_, mask_);
-        future.wait();
-
-        if (future.get()) {
-            controller_.read_global_prefs("localhost");
-            close();
-            return;
-        } else {
-            error = QString::fromUtf8("The client could not save the preferences.");
-        }
+        controller_.save_global_prefs("localhost", prefs_, mask_, this, [this](woinc::ui::Result<bool> result) {
+            try {
+                if (result.value()) {
+                    controller_.read_global_prefs("localhost");
+                    close();
+                } else {
+                    show_save_error_(QString::fromUtf8("The client could not save the preferences."));
+                }
+            } catch (std::exception &e) {
+                show_save_error_(QString::fromUtf8(e.what()));
+            }
+        });
+        return;
     } catch (woinc::ui::ShutdownException &) {
         error = QString::fromUtf8("Not connected to host");
     } catch (woinc::ui::UnknownHostException &e) {
@@ -747,6 +750,10 @@ void PreferencesDialog::save() {
         error = QString::fromUtf8(e.what());
     }
 
+    show_save_error_(error);
+}
+
+void PreferencesDialog::show_save_error_(const QString &error) {
     QMessageBox::critical(this, QString::fromUtf8("Error"), error, QMessageBox::Ok);
     done(QDialog::Accepted);
 }
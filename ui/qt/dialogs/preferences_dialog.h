@@ -143,6 +143,9 @@ class PreferencesDialog : public QDialog {
     private slots:
         void save();
 
+    private:
+        void show_save_error_(const QString &error);
+
     private:
         Controller &controller_;
         GlobalPreferences prefs_;
@@ -0,0 +1,201 @@
+/* ui/qt/event_store.cc --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#include "qt/event_store.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <QByteArray>
+
+namespace {
+
+// the files grow by doubling their size, starting with these sizes in bytes
+const qint64 INITIAL_DATA_CAPACITY = 1 << 20;
+const qint64 INITIAL_INDEX_CAPACITY = 1 << 16;
+
+// each record in the data file starts with the lengths of the UTF-8 encoded project name and message
+typedef quint32 RecordLengths[2];
+
+}
+
+namespace woinc { namespace ui { namespace qt {
+
+#define WOINC_LOCK_GUARD std::lock_guard<decltype(lock_)> guard(lock_)
+
+EventStore::EventStore(const QString &path)
+    : data_file_(path + QString::fromUtf8(".data"))
+    , index_file_(path + QString::fromUtf8(".index"))
+{
+    if (!path.isEmpty())
+        valid_ = data_file_.open(QIODevice::ReadWrite | QIODevice::Truncate)
+            && index_file_.open(QIODevice::ReadWrite | QIODevice::Truncate);
+}
+
+EventStore::~EventStore() {
+    if (data_ != nullptr)
+        data_file_.unmap(data_);
+    if (index_ != nullptr)
+        index_file_.unmap(index_);
+    // closes the files before removing them
+    if (data_file_.isOpen())
+        data_file_.remove();
+    if (index_file_.isOpen())
+        index_file_.remove();
+}
+
+void EventStore::append(const Events &events) {
+    WOINC_LOCK_GUARD;
+
+    if (!valid_)
+        return;
+
+    for (const auto &event : events) {
+        const QByteArray project_name = event.project_name.toUtf8();
+        const QByteArray message = event.message.toUtf8();
+
+        const RecordLengths lengths = {
+            static_cast<quint32>(project_name.size()),
+            static_cast<quint32>(message.size())
+        };
+        const qint64 record_size = static_cast<qint64>(sizeof(lengths)) + project_name.size() + message.size();
+        const qint64 index_size = static_cast<qint64>(sizeof(IndexEntry)) * (size_ + 1);
+
+        if (!reserve_(data_file_, data_, data_capacity_, data_size_ + record_size)
+                || !reserve_(index_file_, index_, index_capacity_, index_size)) {
+            // the stored events can't be read anymore if a file couldn't be remapped
+            valid_ = false;
+            size_ = 0;
+            return;
+        }
+
+        uchar *record = data_ + data_size_;
+        std::memcpy(record, lengths, sizeof(lengths));
+        record += sizeof(lengths);
+        std::memcpy(record, project_name.constData(), lengths[0]);
+        record += lengths[0];
+        std::memcpy(record, message.constData(), lengths[1]);
+
+        const IndexEntry entry = {
+            data_size_,
+            static_cast<qint64>(event.timestamp),
+            static_cast<qint32>(event.seqno),
+            event.user_alert ? 1 : 0
+        };
+        std::memcpy(index_ + index_size - static_cast<qint64>(sizeof(IndexEntry)), &entry, sizeof(entry));
+
+        data_size_ += record_size;
+        ++size_;
+    }
+}
+
+int EventStore::size() const {
+    WOINC_LOCK_GUARD;
+    return size_;
+}
+
+Event EventStore::at(int row) const {
+    WOINC_LOCK_GUARD;
+
+    Event event = Event();
+
+    // rows beyond the size are only requested if the store became invalid
+    if (row < 0 || row >= size_)
+        return event;
+
+    const IndexEntry entry = index_entry_(row);
+    const uchar *record = data_ + entry.offset;
+
+    RecordLengths lengths;
+    std::memcpy(lengths, record, sizeof(lengths));
+    const char *strings = reinterpret_cast<const char *>(record + sizeof(lengths));
+
+    event.project_name = QString::fromUtf8(strings, static_cast<int>(lengths[0]));
+    event.message = QString::fromUtf8(strings + lengths[0], static_cast<int>(lengths[1]));
+    event.seqno = entry.seqno;
+    event.timestamp = static_cast<time_t>(entry.timestamp);
+    event.user_alert = entry.user_alert != 0;
+
+    return event;
+}
+
+int EventStore::lower_bound_by_seqno(int seqno) const {
+    return lower_bound_([seqno](const IndexEntry &entry) { return entry.seqno < seqno; });
+}
+
+int EventStore::lower_bound_by_timestamp(time_t timestamp) const {
+    return lower_bound_([timestamp](const IndexEntry &entry) {
+        return entry.timestamp < static_cast<qint64>(timestamp);
+    });
+}
+
+EventStore::IndexEntry EventStore::index_entry_(int row) const {
+    assert(row >= 0 && row < size_);
+    IndexEntry entry;
+    std::memcpy(&entry, index_ + static_cast<qint64>(sizeof(IndexEntry)) * row, sizeof(entry));
+    return entry;
+}
+
+bool EventStore::reserve_(QFile &file, uchar *&map, qint64 &capacity, qint64 size) {
+    if (size <= capacity)
+        return true;
+
+    const qint64 initial_capacity = &file == &data_file_ ? INITIAL_DATA_CAPACITY : INITIAL_INDEX_CAPACITY;
+    qint64 new_capacity = std::max(capacity * 2, initial_capacity);
+    while (new_capacity < size)
+        new_capacity *= 2;
+
+    if (map != nullptr) {
+        file.unmap(map);
+        map = nullptr;
+    }
+
+    if (!file.resize(new_capacity))
+        return false;
+
+    map = file.map(0, new_capacity);
+    if (map == nullptr)
+        return false;
+
+    capacity = new_capacity;
+    return true;
+}
+
+template<typename LESS>
+int EventStore::lower_bound_(LESS less) const {
+    WOINC_LOCK_GUARD;
+
+    int first = 0;
+    int count = size_;
+
+    while (count > 0) {
+        const int step = count / 2;
+        if (less(index_entry_(first + step))) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+
+    return first;
+}
+
+}}}
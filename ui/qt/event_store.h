@@ -0,0 +1,101 @@
+/* ui/qt/event_store.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+#ifndef WOINC_UI_QT_EVENT_STORE_H_
+#define WOINC_UI_QT_EVENT_STORE_H_
+
+#include <ctime>
+#include <memory>
+#include <mutex>
+
+#include <QFile>
+#include <QMetaType>
+#include <QString>
+
+#include "qt/types.h"
+
+namespace woinc { namespace ui { namespace qt {
+
+/*
+ * An append-only store of the events of a host, backed by memory-mapped files.
+ *
+ * The events are kept in a data file and a fixed-size index entry per event, so an event is read
+ * by its row in constant time and the pages of the files are loaded by the OS on demand only.
+ * The rows are kept in the order the events were appended, i.e. ordered by seqno and timestamp as
+ * long as the client isn't restarted.
+ *
+ * The store is threadsafe. The files are removed when the store is destroyed.
+ */
+class EventStore {
+    public:
+        // creates the files path.data and path.index; if the path is empty or the files can't be created,
+        // the store stays empty
+        explicit EventStore(const QString &path);
+        ~EventStore();
+
+        EventStore(const EventStore &) = delete;
+        EventStore(EventStore &&) = delete;
+
+        EventStore &operator=(const EventStore &) = delete;
+        EventStore &operator=(EventStore &&) = delete;
+
+        void append(const Events &events);
+
+        int size() const;
+        Event at(int row) const;
+
+        // the first row with a seqno respectively timestamp not less than the given one
+        int lower_bound_by_seqno(int seqno) const;
+        int lower_bound_by_timestamp(time_t timestamp) const;
+
+    private:
+        struct IndexEntry {
+            qint64 offset;
+            qint64 timestamp;
+            qint32 seqno;
+            qint32 user_alert;
+        };
+
+        IndexEntry index_entry_(int row) const;
+        bool reserve_(QFile &file, uchar *&map, qint64 &capacity, qint64 size);
+
+        template<typename LESS>
+        int lower_bound_(LESS less) const;
+
+    private:
+        mutable std::mutex lock_;
+
+        QFile data_file_;
+        QFile index_file_;
+
+        uchar *data_ = nullptr;
+        uchar *index_ = nullptr;
+
+        qint64 data_capacity_ = 0;
+        qint64 data_size_ = 0;
+        qint64 index_capacity_ = 0;
+
+        int size_ = 0;
+        bool valid_ = false;
+};
+
+}}}
+
+Q_DECLARE_METATYPE(std::shared_ptr<const woinc::ui::qt::EventStore>)
+
+#endif
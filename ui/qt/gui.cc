@@ -130,13 +130,17 @@ void Gui::create_options_menu_(const Model &model, Controller &controller) {
 
     connect(options_menu, &OptionsMenu::computation_preferences_to_be_shown,
             [=,&controller](QString host) {
-                auto prefs_future = controller.load_global_prefs(host, GET_GLOBAL_PREFS_MODE::WORKING);
-                prefs_future.wait();
                 try {
-                    auto prefs = prefs_future.get();
-                    auto dlg = new PreferencesDialog(controller, std::move(prefs), this);
-                    dlg->setAttribute(Qt::WA_DeleteOnClose);
-                    dlg->open();
+                    controller.load_global_prefs(host, GET_GLOBAL_PREFS_MODE::WORKING, this,
+                                                 [=,&controller](woinc::ui::Result<GlobalPreferences> result) {
+                        try {
+                            auto dlg = new PreferencesDialog(controller, std::move(result).value(), this);
+                            dlg->setAttribute(Qt::WA_DeleteOnClose);
+                            dlg->open();
+                        } catch (std::exception &e) {
+                            show_error(QString::fromUtf8("Error"), QString::fromUtf8(e.what()));
+                        }
+                    });
                 } catch (std::exception &e) {
                     show_error(QString::fromUtf8("Error"), QString::fromUtf8(e.what()));
                 }
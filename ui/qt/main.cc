@@ -17,18 +17,24 @@
    along with woinc. If not, see <http://www.gnu.org/licenses/>. */
 
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
 
 #include <QApplication>
+#include <QThread>
 
 #include <woinc/defs.h>
+#include <woinc/trace.h>
 #include <woinc/types.h>
 
 #include "qt/adapter.h"
 #include "qt/controller.h"
 #include "qt/defs.h"
+#include "qt/event_store.h"
 #include "qt/gui.h"
 #include "qt/model_handler.h"
+#include "qt/search_index.h"
 #include "qt/types.h"
 
 namespace woincqt = woinc::ui::qt;
@@ -47,15 +53,31 @@ void connect_gui_app__(woincqt::Gui *gui, QApplication *app);
 }
 
 int main(int argc, char **argv) {
+    // records a trace into the given file, see woinc/trace.h
+    const char *trace_file = std::getenv("WOINC_TRACE");
+    if (trace_file != nullptr) {
+        woinc::trace::enable(true);
+        woinc::trace::thread_name("qt main");
+    }
+
     QApplication app(argc, argv);
 
     register_meta_types__();
 
     woincqt::Controller controller;
     woincqt::Gui gui;
+    QThread model_thread; // must outlive the model
     woincqt::ModelHandler model;
     woincqt::HandlerAdapter adapter;
 
+    // maps the updates into the types of the GUI in its own thread, the results are delivered
+    // to the widgets in the GUI thread via the (therefore queued) signals of the model
+    model_thread.setObjectName(QString::fromUtf8("model"));
+    if (trace_file != nullptr)
+        QObject::connect(&model_thread, &QThread::started, []() { woinc::trace::thread_name("qt model"); });
+    model.moveToThread(&model_thread);
+    model_thread.start();
+
     controller.connect(&adapter);
 
     connect_adapter_model__(&adapter, &model);
@@ -78,7 +100,24 @@ int main(int argc, char **argv) {
                                      QString::fromUtf8(argv[1]));
     }
 
-    return app.exec();
+    // adds the hosts of the inventory file, see woinc/ui/inventory.h
+    const char *inventory = std::getenv("WOINC_INVENTORY");
+    if (inventory != nullptr)
+        controller.add_hosts(QString::fromLocal8Bit(inventory));
+
+    int result = app.exec();
+
+    model_thread.quit();
+    model_thread.wait();
+
+    if (trace_file != nullptr) {
+        std::ofstream trace_out(trace_file);
+        woinc::trace::dump(trace_out);
+        if (!trace_out)
+            std::cerr << "Could not write the trace to " << trace_file << std::endl;
+    }
+
+    return result;
 }
 
 namespace {
@@ -86,19 +125,21 @@ namespace {
 void register_meta_types__() {
     qRegisterMetaType<woinc::ui::Error>();
 
-    qRegisterMetaType<woinc::CCStatus>();
-    qRegisterMetaType<woinc::ClientState>();
-    qRegisterMetaType<woinc::DiskUsage>();
-    qRegisterMetaType<woinc::FileTransfers>();
-    qRegisterMetaType<woinc::Notices>();
-    qRegisterMetaType<woinc::Messages>();
-    qRegisterMetaType<woinc::Projects>();
-    qRegisterMetaType<woinc::Statistics>();
-    qRegisterMetaType<woinc::Tasks>();
+    qRegisterMetaType<std::shared_ptr<const woinc::CCStatus>>();
+    qRegisterMetaType<std::shared_ptr<const woinc::ClientState>>();
+    qRegisterMetaType<std::shared_ptr<const woinc::DiskUsage>>();
+    qRegisterMetaType<std::shared_ptr<const woinc::FileTransfers>>();
+    qRegisterMetaType<std::shared_ptr<const woinc::Notices>>();
+    qRegisterMetaType<std::shared_ptr<const woinc::Messages>>();
+    qRegisterMetaType<std::shared_ptr<const woinc::Projects>>();
+    qRegisterMetaType<std::shared_ptr<const woinc::Statistics>>();
+    qRegisterMetaType<std::shared_ptr<const woinc::Tasks>>();
 
     qRegisterMetaType<woinc::ui::qt::AppVersions>();
     qRegisterMetaType<woinc::ui::qt::DiskUsage>();
     qRegisterMetaType<woinc::ui::qt::Events>();
+    qRegisterMetaType<std::shared_ptr<const woinc::ui::qt::EventStore>>();
+    qRegisterMetaType<std::shared_ptr<const woinc::ui::qt::SearchIndex>>();
     qRegisterMetaType<woinc::ui::qt::FileTransfers>();
     qRegisterMetaType<woinc::ui::qt::Notices>();
     qRegisterMetaType<woinc::ui::qt::Project>();
@@ -115,6 +156,12 @@ void connect_adapter_model__(woincqt::HandlerAdapter *adapter, woincqt::ModelHan
                                                  Qt::QueuedConnection)
     WOINC_CONNECT(added, add_host);
     WOINC_CONNECT(removed, remove_host);
+#undef WOINC_CONNECT
+
+    // the updates are emitted by the adapter when draining its mailboxes in the gui thread,
+    // which are therefore queued into the thread of the model
+#define WOINC_CONNECT(FROM, TO) QObject::connect(adapter, &woincqt::HandlerAdapter::FROM, \
+                                                 model, &woincqt::ModelHandler::TO)
     WOINC_CONNECT(updated_cc_status, update_cc_status);
     WOINC_CONNECT(updated_client_state, update_client_state);
     WOINC_CONNECT(updated_disk_usage, update_disk_usage);
@@ -147,6 +194,8 @@ void connect_model_controller__(woincqt::ModelHandler *model, woincqt::Controlle
     WOINC_CONNECT(state_update_needed     , schedule_state_update);
     WOINC_CONNECT(statistics_update_needed, schedule_statistics_update);
     WOINC_CONNECT(tasks_update_needed     , schedule_tasks_update);
+    WOINC_CONNECT(host_selected           , subscribe_host);
+    WOINC_CONNECT(host_unselected         , unsubscribe_host);
 #undef WOINC_CONNECT
 }
 
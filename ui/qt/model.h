@@ -19,9 +19,13 @@
 #ifndef WOINC_UI_QT_MODEL_H_
 #define WOINC_UI_QT_MODEL_H_
 
+#include <memory>
+
 #include <QObject>
 #include <QString>
 
+#include "qt/event_store.h"
+#include "qt/search_index.h"
 #include "qt/types.h"
 
 namespace woinc { namespace ui { namespace qt {
@@ -44,10 +48,13 @@ class Model : public QObject {
         void host_unselected(QString host);
 
         void disk_usage_updated(woinc::ui::qt::DiskUsage disk_usage);
-        void events_appended(woinc::ui::qt::Events events);
+        // the events of the selected host are read from its store, a null store when no host is selected
+        void events_selected(std::shared_ptr<const woinc::ui::qt::EventStore> events,
+                             std::shared_ptr<const woinc::ui::qt::SearchIndex> index);
+        void events_appended(int num_events);
         void file_transfers_updated(woinc::ui::qt::FileTransfers transfers);
         void notices_appended(woinc::ui::qt::Notices notices);
-        void notices_refreshed(woinc::ui::qt::Notices notices);
+        void notices_refreshed(woinc::ui::qt::Notices notices, std::shared_ptr<const woinc::ui::qt::SearchIndex> index);
         void projects_updated(woinc::ui::qt::Projects projects);
         void run_modes_updated(woinc::ui::qt::RunModes run_modes);
         void statistics_updated(woinc::ui::qt::Statistics statistics);
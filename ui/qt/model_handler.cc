@@ -18,11 +18,11 @@
 
 #include "qt/model_handler.h"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cmath>
 #include <cstdlib>
-#include <type_traits>
 
 #ifndef NDEBUG
 #include <iostream>
@@ -38,151 +38,8 @@ namespace {
 
 namespace wqt = woinc::ui::qt;
 
-template<typename T>
-int compare(const T &a, const T &b) {
-    static_assert(std::is_arithmetic<T>::value, "Arithmetic type needed");
-    if (a < b) return -1;
-    if (a > b) return 1;
-    return 0;
-}
-
-template<>
-int compare(const QString &a, const QString &b) {
-    return a.localeAwareCompare(b);
-}
-
-template<>
-int compare(const woinc::ui::qt::Task &a, const woinc::ui::qt::Task &b) {
-    int result = compare(a.project, b.project);
-    if (!result)
-        result = compare(a.task_name, b.task_name);
-    return result;
-}
-
-template<>
-int compare(const woinc::ui::qt::Project &a,
-            const woinc::ui::qt::Project &b) {
-    return compare(a.name, b.name);
-}
-
-bool uses_gpu(const woinc::Task &task) {
-    // TODO is there another way to determine this?
-    return task.resources.find("GPU") != task.resources.npos;
-}
-
-// TODO see BOINC's clientgui/MainDocument.cpp result_description(RESULT* result, bool show_resources)
-QString resolve_task_status(const woinc::Task &task,
-                            const woinc::CCStatus &cc_status,
-                            bool non_cpu_intensive) {
-    QString result;
-    QTextStream ss(&result);
-
-    bool throttled = cc_status.cpu.suspend_reason == woinc::SUSPEND_REASON::CPU_THROTTLE;
-
-    auto handle_state_new = [&]() { ss << "New"; };
-
-    auto handle_state_files_downloading = [&]() {
-        if (task.ready_to_report) {
-            ss << "Download failed";
-        } else {
-            ss << "Downloading";
-            if (cc_status.network.suspend_reason != woinc::SUSPEND_REASON::NOT_SUSPENDED)
-                ss << " (suspended - " << woinc::ui::common::to_string(cc_status.network.suspend_reason) << ")";
-        }
-    };
-
-    auto handle_state_files_downloaded = [&]() {
-        if (task.project_suspended_via_gui) {
-            ss << "Project suspended by user";
-        } else if (task.suspended_via_gui) {
-            ss << "Task suspended by user";
-        } else if (cc_status.cpu.suspend_reason != woinc::SUSPEND_REASON::NOT_SUSPENDED
-                   && !throttled
-                   && task.active_task != nullptr
-                   && task.active_task->active_task_state != woinc::ACTIVE_TASK_STATE::EXECUTING) {
-            ss << "Suspended - " << woinc::ui::common::to_string(cc_status.cpu.suspend_reason);
-        } else if (cc_status.gpu.suspend_reason != woinc::SUSPEND_REASON::NOT_SUSPENDED && uses_gpu(task)) {
-            ss << "GPU suspended - " << woinc::ui::common::to_string(cc_status.gpu.suspend_reason);
-        } else if (task.active_task != nullptr) {
-            if (task.active_task->too_large) {
-                ss << "Waiting for memory";
-            } else if (task.active_task->needs_shmem) {
-                ss << "Waiting for shared memory";
-            } else if (task.active_task->scheduler_state == woinc::SCHEDULER_STATE::SCHEDULED) {
-                ss << "Running";
-                if (non_cpu_intensive)
-                    ss << " (non-CPU-intensive)";
-            } else if (task.active_task->scheduler_state == woinc::SCHEDULER_STATE::PREEMPTED) {
-                ss << "Waiting to run";
-            } else if (task.active_task->scheduler_state == woinc::SCHEDULER_STATE::UNINITIALIZED) {
-                ss << "Ready to start";
-            }
-        } else {
-            ss << "Ready to start";
-        }
-        if (task.scheduler_wait) {
-            // TODO: this is what BOINC does, but I'm not yet sure, if it's the right thing to do here ..
-            // why delete the maybe existing 'GPU missing' string?
-            result = "";
-            ss << "Postponed";
-            if (!task.scheduler_wait_reason.empty())
-                ss << ": " << QString::fromStdString(task.scheduler_wait_reason);
-        }
-        if (task.network_wait) {
-            // TODO: this is what BOINC does, but I'm not yet sure, if it's the right thing to do here ..
-            // why delete the maybe existing 'GPU missing' string?
-            result = "";
-            ss << "Waiting for network access";
-        }
-    };
-
-    auto handle_state_compute_error = [&]() {
-        ss << "Computation error";
-    };
-
-    auto handle_state_files_uploading = [&]() {
-        if (task.ready_to_report) {
-            ss << "Upload failed";
-        } else {
-            ss << "Uploading";
-            if (cc_status.network.suspend_reason != woinc::SUSPEND_REASON::NOT_SUSPENDED)
-                ss << " (suspended - " << woinc::ui::common::to_string(cc_status.network.suspend_reason) << ")";
-        }
-    };
-
-    auto handle_state_aborted = [&]() {
-        ss << woinc::ui::common::exit_code_to_string(task.exit_status);
-    };
-
-    auto handle_state_default = [&]() {
-        if (task.got_server_ack) {
-            ss << "Acknowledged";
-        } else if (task.ready_to_report) {
-            ss << "Ready to report";
-        } else {
-            result = "";
-            ss << "Error: invalid state '" << static_cast<int>(task.state) << "'";
-        }
-    };
-
-    if (task.coproc_missing)
-        ss << "GPU missing, ";
-
-    switch (task.state) {
-        case woinc::RESULT_CLIENT_STATE::NEW:               handle_state_new(); break;
-        case woinc::RESULT_CLIENT_STATE::FILES_DOWNLOADING: handle_state_files_downloading(); break;
-        case woinc::RESULT_CLIENT_STATE::FILES_DOWNLOADED:  handle_state_files_downloaded(); break;
-        case woinc::RESULT_CLIENT_STATE::COMPUTE_ERROR:     handle_state_compute_error(); break;
-        case woinc::RESULT_CLIENT_STATE::FILES_UPLOADING:   handle_state_files_uploading(); break;
-        case woinc::RESULT_CLIENT_STATE::ABORTED:           handle_state_aborted(); break;
-        default: handle_state_default();
-    }
-
-    if (!task.resources.empty())
-        ss << " (" << QString::fromStdString(task.resources) << ")";
-
-    return result;
-}
+// the number of recently selected hosts whose entities are mapped on every update
+const size_t MAX_MAPPED_HOSTS = 4;
 
 QString duration_to_string(const std::chrono::seconds &duration) {
     auto dv = std::div(static_cast<int>(duration.count()), 3600);
@@ -290,64 +147,132 @@ QString resolve_transfer_status(const woinc::FileTransfer &file_transfer, const
 
 namespace woinc { namespace ui { namespace qt {
 
-ModelHandler::HostModel::HostModel(const QString &h) : host(h) {}
+ModelHandler::HostModel::HostModel(const QString &h)
+    : host(h)
+    , event_index(std::make_shared<SearchIndex>())
+    , notice_index(std::make_shared<SearchIndex>())
+{}
 
-QVariant ModelHandler::HostModel::resolve_app_name_by_wu(const QString &wu_name) const {
-    auto wup = std::find_if(wus.cbegin(), wus.cend(), [&](const Workunit &w) {
-        return w.name == wu_name;
-    });
+void ModelHandler::HostModel::release() {
+    app_versions = AppVersions();
+    apps         = Apps();
+    projects     = Projects();
+    tasks        = Tasks();
+    wus          = Workunits();
 
-    if (wup == wus.cend())
-        return {};
+    app_index_.clear();
+    app_version_index_.clear();
+    project_index_.clear();
+    wu_index_.clear();
+    app_names_.clear();
 
-    auto app = std::find_if(apps.cbegin(), apps.cend(), [&](const App &a) {
-        return a.project_url == wup->project_url && a.name == wup->app_name;
-    });
+    stale.client_state = stale.projects = stale.tasks = true;
+}
 
-    if (app == apps.cend())
-        return {};
+void ModelHandler::HostModel::reindex_client_state() {
+    app_index_.clear();
+    app_version_index_.clear();
+    wu_index_.clear();
 
-    auto app_version = std::find_if(app_versions.cbegin(), app_versions.cend(), [&](const AppVersion &av) {
-        return av.project_url == wup->project_url && av.app_name == wup->app_name;
-    });
+    app_index_.reserve(static_cast<int>(apps.size()));
+    app_version_index_.reserve(static_cast<int>(app_versions.size()));
+    wu_index_.reserve(static_cast<int>(wus.size()));
 
-    if (app_version == app_versions.cend())
-        return {};
+    // the first entry wins, like the linear searches did before
+    for (size_t i = 0; i < apps.size(); ++i) {
+        const auto key = qMakePair(apps[i].project_url, apps[i].name);
+        if (!app_index_.contains(key))
+            app_index_.insert(key, i);
+    }
 
-    auto project = std::find_if(projects.cbegin(), projects.cend(), [&](const Project &p) {
-        return p.project_url == wup->project_url;
-    });
+    for (size_t i = 0; i < app_versions.size(); ++i) {
+        const auto key = qMakePair(app_versions[i].project_url, app_versions[i].app_name);
+        if (!app_version_index_.contains(key))
+            app_version_index_.insert(key, i);
+    }
 
-    if (project == projects.cend())
-        return {};
+    for (size_t i = 0; i < wus.size(); ++i)
+        if (!wu_index_.contains(wus[i].name))
+            wu_index_.insert(wus[i].name, i);
 
-    QString app_name;
-    if (!app->user_friendly_name.isEmpty())
-        app_name = app->user_friendly_name;
-    else
-        app_name = app_version->app_name;
+    reindex_app_names_();
+}
 
-    QString plan_class;
-    if (!app_version->plan_class.isEmpty())
-        QTextStream(&plan_class) << " (" << app_version->plan_class << ")";
+void ModelHandler::HostModel::reindex_projects() {
+    project_index_.clear();
+    project_index_.reserve(static_cast<int>(projects.size()));
 
-    QString anon_platform;
-    if (project->anonymous_platform)
-        anon_platform = QString::fromUtf8("Local: ");
+    for (size_t i = 0; i < projects.size(); ++i)
+        if (!project_index_.contains(projects[i].project_url))
+            project_index_.insert(projects[i].project_url, i);
 
-    QString version = QString::asprintf(" %d.%02d", app_version->version_num / 100, app_version->version_num % 100);
+    // the app names depend on the anonymous platform flag of the projects
+    reindex_app_names_();
+}
 
-    QString result;
-    QTextStream(&result) << anon_platform << app_name << version << plan_class;
-    return {result.trimmed()};
+void ModelHandler::HostModel::reindex_app_names_() {
+    app_names_.clear();
+    app_names_.reserve(app_index_.size());
+
+    for (auto iter = app_index_.cbegin(); iter != app_index_.cend(); ++iter) {
+        const auto &key = iter.key();
+        const auto &app = apps[iter.value()];
+
+        auto app_version = find_app_version(key);
+        auto project = find_project(key.first);
+
+        if (app_version == nullptr || project == nullptr)
+            continue;
+
+        QString app_name;
+        if (!app.user_friendly_name.isEmpty())
+            app_name = app.user_friendly_name;
+        else
+            app_name = app_version->app_name;
+
+        QString plan_class;
+        if (!app_version->plan_class.isEmpty())
+            QTextStream(&plan_class) << " (" << app_version->plan_class << ")";
+
+        QString anon_platform;
+        if (project->anonymous_platform)
+            anon_platform = QString::fromUtf8("Local: ");
+
+        QString version = QString::asprintf(" %d.%02d", app_version->version_num / 100, app_version->version_num % 100);
+
+        QString result;
+        QTextStream(&result) << anon_platform << app_name << version << plan_class;
+        app_names_.insert(key, result.trimmed());
+    }
+}
+
+const AppVersion *ModelHandler::HostModel::find_app_version(const AppKey &key) const {
+    auto iter = app_version_index_.constFind(key);
+    return iter == app_version_index_.cend() ? nullptr : &app_versions[iter.value()];
+}
+
+const Project *ModelHandler::HostModel::find_project(const QString &project_url) const {
+    auto iter = project_index_.constFind(project_url);
+    return iter == project_index_.cend() ? nullptr : &projects[iter.value()];
+}
+
+const Workunit *ModelHandler::HostModel::find_wu(const QString &wu_name) const {
+    auto iter = wu_index_.constFind(wu_name);
+    return iter == wu_index_.cend() ? nullptr : &wus[iter.value()];
+}
+
+QVariant ModelHandler::HostModel::resolve_app_name_by_wu(const QString &wu_name) const {
+    auto wu = find_wu(wu_name);
+    if (wu == nullptr)
+        return {};
+
+    auto iter = app_names_.constFind(qMakePair(wu->project_url, wu->app_name));
+    return iter == app_names_.cend() ? QVariant{} : QVariant{iter.value()};
 }
 
 QVariant ModelHandler::HostModel::resolve_project_name_by_url(const std::string &master_url) const {
-    QString qurl = QString::fromStdString(master_url);
-    auto it = std::find_if(projects.cbegin(), projects.cend(), [&](const Project &project) {
-        return project.project_url == qurl;
-    });
-    return it == projects.cend() ? QVariant{} : QVariant{it->name};
+    auto project = find_project(QString::fromStdString(master_url));
+    return project == nullptr ? QVariant{} : QVariant{project->name};
 }
 
 // ---- ModelHandler ----
@@ -357,7 +282,11 @@ ModelHandler::ModelHandler(QObject *parent)
 {}
 
 void ModelHandler::add_host(QString host) {
-    host_models_.emplace(host, HostModel(host));
+    HostModel host_model(host);
+    // the host name may contain characters not allowed in file names
+    host_model.events = std::make_shared<EventStore>(
+        events_dir_.isValid() ? events_dir_.filePath(QString::number(++num_event_stores_)) : QString());
+    host_models_.emplace(host, std::move(host_model));
 
     if (selected_host_.isEmpty())
         select_host_(host);
@@ -365,32 +294,46 @@ void ModelHandler::add_host(QString host) {
 
 void ModelHandler::remove_host(QString host) {
     unselect_host_(host);
+    mapped_hosts_.remove(host);
     host_models_.erase(host);
 }
 
-void ModelHandler::update_cc_status(QString host, woinc::CCStatus cc_status) {
-    find_host_model_(host).cc_status = std::move(cc_status);
-    if (selected_host_ == host)
-        emit run_modes_updated(map_(find_host_model_(host).cc_status));
+void ModelHandler::update_cc_status(QString host, std::shared_ptr<const woinc::CCStatus> cc_status) {
+    if (!known_host_(host))
+        return;
 
+    auto &host_model = find_host_model_(host);
+    host_model.cc_status = *cc_status;
+    host_model.raw.cc_status = std::move(cc_status);
+    if (selected_host_ == host)
+        emit run_modes_updated(map_(host_model.cc_status));
 }
 
-void ModelHandler::update_client_state(QString host, woinc::ClientState wclient_state) {
+void ModelHandler::update_client_state(QString host, std::shared_ptr<const woinc::ClientState> wclient_state) {
+    if (!known_host_(host))
+        return;
+
     auto &host_model = find_host_model_(host);
 
-    host_model.app_versions  = map_(std::move(wclient_state.app_versions));
-    host_model.apps          = map_(std::move(wclient_state.apps));
-    host_model.projects      = map_(std::move(wclient_state.projects));
-    host_model.wus           = map_(std::move(wclient_state.workunits));
+    // the projects and tasks of the client state are newer than the ones received before
+    host_model.raw.client_state = std::move(wclient_state);
+    host_model.raw.projects.reset();
+    host_model.raw.tasks.reset();
+    host_model.stale.client_state = host_model.stale.projects = host_model.stale.tasks = true;
 
-    auto tasks               = map_(std::move(wclient_state.tasks), host_model);
-    assert(tasks.isValid());
-    host_model.tasks         = tasks.value<Tasks>();
+    if (is_mapped_(host))
+        map_stale_(host_model);
 }
 
-void ModelHandler::update_disk_usage(QString host, woinc::DiskUsage wdisk_usage) {
+void ModelHandler::update_disk_usage(QString host, std::shared_ptr<const woinc::DiskUsage> wdisk_usage) {
+    if (!known_host_(host))
+        return;
+
+    auto &host_model = find_host_model_(host);
+    host_model.raw.disk_usage = wdisk_usage;
+
     if (selected_host_ == host) {
-        auto usage = map_(std::move(wdisk_usage), find_host_model_(host));
+        auto usage = map_(*wdisk_usage, host_model);
         if (usage.isValid()) {
             emit disk_usage_updated(usage.value<DiskUsage>());
         } else {
@@ -400,31 +343,61 @@ void ModelHandler::update_disk_usage(QString host, woinc::DiskUsage wdisk_usage)
     }
 }
 
-void ModelHandler::update_file_transfers(QString host, woinc::FileTransfers wfile_transfers) {
+void ModelHandler::update_file_transfers(QString host, std::shared_ptr<const woinc::FileTransfers> wfile_transfers) {
+    if (!known_host_(host))
+        return;
+
+    auto &host_model = find_host_model_(host);
+    host_model.raw.file_transfers = wfile_transfers;
+
     if (selected_host_ == host)
-        emit file_transfers_updated(map_(std::move(wfile_transfers), find_host_model_(host)));
+        emit file_transfers_updated(map_(*wfile_transfers, host_model));
 }
 
-void ModelHandler::update_messages(QString host, woinc::Messages wmessages) {
-    if (wmessages.empty())
+void ModelHandler::update_messages(QString host, std::shared_ptr<const woinc::Messages> wmessages) {
+    if (wmessages->empty() || !known_host_(host))
         return;
 
+    auto &host_model = find_host_model_(host);
+    auto events = map_(*wmessages);
+
+    host_model.events->append(events);
+    for (const auto &event : events)
+        host_model.event_index->add(event.project_name, event.timestamp, event.message);
+
     if (selected_host_ == host)
-        emit events_appended(map_(std::move(wmessages)));
+        emit events_appended(host_model.events->size());
 }
 
-void ModelHandler::update_notices(QString host, woinc::Notices wnotices, bool refreshed) {
+void ModelHandler::update_notices(QString host, std::shared_ptr<const woinc::Notices> wnotices, bool refreshed) {
+    if (!known_host_(host))
+        return;
+
+    auto &host_model = find_host_model_(host);
+    auto notices = map_(*wnotices);
+
+    // a new index instead of clearing it, the notices tab may still query the current one
+    if (refreshed) {
+        host_model.notices.clear();
+        host_model.notice_index = std::make_shared<SearchIndex>();
+    }
+
+    for (const auto &notice : notices)
+        host_model.notice_index->add(notice.project_name, notice.create_time,
+                                     notice.title + QString::fromUtf8(" ") + notice.description, true);
+    host_model.notices.insert(host_model.notices.end(), notices.begin(), notices.end());
+
     if (selected_host_ != host)
         return;
 
     if (refreshed)
-        emit notices_refreshed(map_(std::move(wnotices)));
+        emit notices_refreshed(host_model.notices, host_model.notice_index);
     else
-        emit notices_appended(map_(std::move(wnotices)));
+        emit notices_appended(std::move(notices));
 }
 
 // TODO update tasks if needed, i.e. the suspension state of projects changed
-void ModelHandler::update_projects(QString host, woinc::Projects wprojects) {
+void ModelHandler::update_projects(QString host, std::shared_ptr<const woinc::Projects> wprojects) {
 #if 0
 #ifndef NDEBUG
     static size_t cnt = 0;
@@ -437,14 +410,22 @@ void ModelHandler::update_projects(QString host, woinc::Projects wprojects) {
     ++ cnt;
 #endif
 #endif
-    Projects projects(map_(std::move(wprojects)));
+    if (!known_host_(host))
+        return;
+
+    auto &host_model = find_host_model_(host);
+    host_model.raw.projects = std::move(wprojects);
+    host_model.stale.projects = true;
+
+    if (!is_mapped_(host))
+        return;
 
-    find_host_model_(host).projects = std::move(projects);
+    map_stale_(host_model);
     if (selected_host_ == host)
-        emit projects_updated(find_host_model_(host).projects);
+        emit projects_updated(host_model.projects);
 }
 
-void ModelHandler::update_statistics(QString host, woinc::Statistics wstatistics) {
+void ModelHandler::update_statistics(QString host, std::shared_ptr<const woinc::Statistics> wstatistics) {
 #if 0
 #ifndef NDEBUG
     static size_t last_size = 0;
@@ -458,8 +439,14 @@ void ModelHandler::update_statistics(QString host, woinc::Statistics wstatistics
     last_size = statistics.project_statistics.size();
 #endif
 #endif
+    if (!known_host_(host))
+        return;
+
+    auto &host_model = find_host_model_(host);
+    host_model.raw.statistics = wstatistics;
+
     if (selected_host_ == host) {
-        auto statistics = map_(std::move(wstatistics), find_host_model_(host));
+        auto statistics = map_(*wstatistics, host_model);
         if (statistics.isValid()) {
             emit statistics_updated(statistics.value<Statistics>());
         } else {
@@ -469,19 +456,22 @@ void ModelHandler::update_statistics(QString host, woinc::Statistics wstatistics
     }
 }
 
-void ModelHandler::update_tasks(QString host, woinc::Tasks wtasks) {
-    // the controller ensures that the host won't be removed while another handler
-    // method is executed, i.e. we don't need to lock for accessing the host;
-    // furthermore there is only one worker thread per host, i.e. the (reading) access the host model without locking is fine
+void ModelHandler::update_tasks(QString host, std::shared_ptr<const woinc::Tasks> wtasks) {
+    if (!known_host_(host))
+        return;
+
+    // all slots are executed in the thread of the model handler, so the host models don't need to be locked
     auto &host_model = find_host_model_(host);
-    auto tasks = map_(std::move(wtasks), host_model);
-    if (!tasks.isValid()) {
+    host_model.raw.tasks = std::move(wtasks);
+    host_model.stale.tasks = true;
+
+    if (!is_mapped_(host))
+        return;
+
+    if (!map_stale_(host_model))
         emit state_update_needed(host);
-    } else {
-        host_model.tasks = tasks.value<Tasks>();
-        if (selected_host_ == host)
-            emit tasks_updated(host_model.tasks);
-    }
+    else if (selected_host_ == host)
+        emit tasks_updated(host_model.tasks);
 }
 
 void ModelHandler::select_host(QString host) {
@@ -496,7 +486,34 @@ void ModelHandler::unselect_host(QString host) {
 void ModelHandler::select_host_(const QString &host) {
     unselect_host_(selected_host_);
     selected_host_ = host;
+    touch_(host);
     emit host_selected(host);
+
+    // publish the latest entities instead of waiting for the next updates
+    auto &host_model = find_host_model_(host);
+    const auto &raw = host_model.raw;
+
+    emit events_selected(host_model.events, host_model.event_index);
+    emit notices_refreshed(host_model.notices, host_model.notice_index);
+
+    if (raw.cc_status)
+        emit run_modes_updated(map_(host_model.cc_status));
+
+    if (!map_stale_(host_model)) {
+        emit state_update_needed(host);
+    } else {
+        if (raw.projects || raw.client_state)
+            emit projects_updated(host_model.projects);
+        if (raw.tasks || raw.client_state)
+            emit tasks_updated(host_model.tasks);
+    }
+
+    if (raw.disk_usage)
+        update_disk_usage(host, raw.disk_usage);
+    if (raw.file_transfers)
+        update_file_transfers(host, raw.file_transfers);
+    if (raw.statistics)
+        update_statistics(host, raw.statistics);
 }
 
 void ModelHandler::unselect_host_(const QString &host) {
@@ -508,15 +525,63 @@ void ModelHandler::unselect_host_(const QString &host) {
 
     // TODO all widgets should connect to the host_unselected signal and update the view
     emit disk_usage_updated({});
-    emit events_appended({});
+    emit events_selected(nullptr, nullptr);
     emit file_transfers_updated({});
-    emit notices_appended({});
-    emit notices_refreshed({});
+    emit notices_refreshed({}, nullptr);
     emit projects_updated({});
     emit statistics_updated({});
     emit tasks_updated({});
 }
 
+bool ModelHandler::is_mapped_(const QString &host) const {
+    return std::find(mapped_hosts_.cbegin(), mapped_hosts_.cend(), host) != mapped_hosts_.cend();
+}
+
+void ModelHandler::touch_(const QString &host) {
+    mapped_hosts_.remove(host);
+    mapped_hosts_.push_front(host);
+
+    while (mapped_hosts_.size() > MAX_MAPPED_HOSTS) {
+        auto host_model = host_models_.find(mapped_hosts_.back());
+        if (host_model != host_models_.end())
+            host_model->second.release();
+        mapped_hosts_.pop_back();
+    }
+}
+
+bool ModelHandler::map_stale_(HostModel &host_model) {
+    auto &raw = host_model.raw;
+    auto &stale = host_model.stale;
+
+    if (stale.client_state && raw.client_state) {
+        host_model.app_versions = map_(raw.client_state->app_versions);
+        host_model.apps         = map_(raw.client_state->apps);
+        host_model.wus          = map_(raw.client_state->workunits);
+        host_model.reindex_client_state();
+        stale.client_state = false;
+    }
+
+    if (stale.projects && (raw.projects || raw.client_state)) {
+        host_model.projects = map_(raw.projects ? *raw.projects : raw.client_state->projects);
+        host_model.reindex_projects();
+        stale.projects = false;
+    }
+
+    if (stale.tasks && (raw.tasks || raw.client_state)) {
+        auto tasks = map_(raw.tasks ? *raw.tasks : raw.client_state->tasks, host_model);
+        if (!tasks.isValid())
+            return false;
+        host_model.tasks = tasks.value<Tasks>();
+        stale.tasks = false;
+    }
+
+    return true;
+}
+
+bool ModelHandler::known_host_(const QString &host) const {
+    return host_models_.find(host) != host_models_.end();
+}
+
 const ModelHandler::HostModel &ModelHandler::find_host_model_(const QString &host) const {
     const auto iter = host_models_.find(host);
     assert(iter != host_models_.end());
@@ -529,7 +594,7 @@ ModelHandler::HostModel &ModelHandler::find_host_model_(const QString &host) {
     return iter->second;
 }
 
-Apps ModelHandler::map_(woinc::Apps wapps) {
+Apps ModelHandler::map_(const woinc::Apps &wapps) {
     Apps apps;
     apps.reserve(wapps.size());
 
@@ -547,7 +612,7 @@ Apps ModelHandler::map_(woinc::Apps wapps) {
     return apps;
 }
 
-AppVersions ModelHandler::map_(woinc::AppVersions wapp_versions) {
+AppVersions ModelHandler::map_(const woinc::AppVersions &wapp_versions) {
     AppVersions app_versions;
     app_versions.reserve(wapp_versions.size());
 
@@ -573,7 +638,7 @@ AppVersions ModelHandler::map_(woinc::AppVersions wapp_versions) {
     return app_versions;
 }
 
-QVariant ModelHandler::map_(woinc::DiskUsage wdisk_usage, const HostModel &host_model) {
+QVariant ModelHandler::map_(const woinc::DiskUsage &wdisk_usage, const HostModel &host_model) {
     double total = wdisk_usage.boinc;
     for (auto &&project : wdisk_usage.projects)
         total += project.disk_usage;
@@ -605,7 +670,7 @@ QVariant ModelHandler::map_(woinc::DiskUsage wdisk_usage, const HostModel &host_
     return QVariant::fromValue(std::move(disk_usage));
 }
 
-FileTransfers ModelHandler::map_(woinc::FileTransfers wfile_transfers, const HostModel &host_model) {
+FileTransfers ModelHandler::map_(const woinc::FileTransfers &wfile_transfers, const HostModel &host_model) {
     FileTransfers file_transfers;
     file_transfers.reserve(wfile_transfers.size());
 
@@ -636,7 +701,7 @@ FileTransfers ModelHandler::map_(woinc::FileTransfers wfile_transfers, const Hos
     return file_transfers;
 }
 
-Events ModelHandler::map_(woinc::Messages wmessages) {
+Events ModelHandler::map_(const woinc::Messages &wmessages) {
     Events events;
     events.reserve(wmessages.size());
 
@@ -655,7 +720,7 @@ Events ModelHandler::map_(woinc::Messages wmessages) {
     return events;
 }
 
-Notices ModelHandler::map_(woinc::Notices wnotices) {
+Notices ModelHandler::map_(const woinc::Notices &wnotices) {
     Notices notices;
     notices.reserve(wnotices.size());
 
@@ -685,7 +750,7 @@ Notices ModelHandler::map_(woinc::Notices wnotices) {
     return notices;
 }
 
-Workunits ModelHandler::map_(woinc::Workunits wwus) {
+Workunits ModelHandler::map_(const woinc::Workunits &wwus) {
     Workunits wus;
     wus.reserve(wwus.size());
 
@@ -704,7 +769,7 @@ Workunits ModelHandler::map_(woinc::Workunits wwus) {
     return wus;
 }
 
-Projects ModelHandler::map_(woinc::Projects wprojects) {
+Projects ModelHandler::map_(const woinc::Projects &wprojects) {
     Projects projects;
     projects.reserve(wprojects.size());
 
@@ -752,13 +817,6 @@ Projects ModelHandler::map_(woinc::Projects wprojects) {
         projects.push_back(std::move(dest));
     }
 
-    // ensure the tasks are always in the same order
-    std::sort(projects.begin(), projects.end(), [](const Project &a, const Project &b) {
-        int result = compare(a, b);
-        assert(result != 0);
-        return result < 0;
-    });
-
     return projects;
 }
 
@@ -770,16 +828,13 @@ RunModes ModelHandler::map_(const woinc::CCStatus &cc_status) {
     return modes;
 }
 
-QVariant ModelHandler::map_(woinc::Statistics wstatistics, const HostModel &host_model) {
+QVariant ModelHandler::map_(const woinc::Statistics &wstatistics, const HostModel &host_model) {
     Statistics statistics;
     statistics.reserve(wstatistics.size());
 
     for (auto &&source : wstatistics) {
-        auto project = std::find_if(host_model.projects.cbegin(), host_model.projects.cend(), [&](const Project &p) {
-            return p.project_url == QString::fromStdString(source.master_url);
-        });
-
-        if (project == host_model.projects.cend())
+        auto project = host_model.find_project(QString::fromStdString(source.master_url));
+        if (project == nullptr)
             return {};
 
         ProjectStatistics dest;
@@ -807,7 +862,7 @@ QVariant ModelHandler::map_(woinc::Statistics wstatistics, const HostModel &host
     return QVariant::fromValue(std::move(statistics));
 }
 
-QVariant ModelHandler::map_(woinc::Tasks wtasks, const HostModel &host_model) {
+QVariant ModelHandler::map_(const woinc::Tasks &wtasks, const HostModel &host_model) {
     Tasks tasks;
     tasks.reserve(wtasks.size());
 
@@ -815,24 +870,19 @@ QVariant ModelHandler::map_(woinc::Tasks wtasks, const HostModel &host_model) {
     for (auto &&source : wtasks) {
         Task dest;
 
-        auto project = std::find_if(host_model.projects.cbegin(), host_model.projects.cend(), [&](const Project &p) {
-            return p.project_url == QString::fromStdString(source.project_url);
-        });
+        const auto wu_name = QString::fromStdString(source.wu_name);
 
-        auto wup = std::find_if(host_model.wus.cbegin(), host_model.wus.cend(), [&](const Workunit &w) {
-            return w.name == QString::fromStdString(source.wu_name);
-        });
+        auto project = host_model.find_project(QString::fromStdString(source.project_url));
 
-        if (wup == host_model.wus.cend())
+        auto wup = host_model.find_wu(wu_name);
+        if (wup == nullptr)
             return {};
 
-        auto app_version = std::find_if(host_model.app_versions.cbegin(), host_model.app_versions.cend(), [&](const AppVersion &av) {
-            return av.project_url == wup->project_url && av.app_name == wup->app_name;
-        });
+        auto app_version = host_model.find_app_version(qMakePair(wup->project_url, wup->app_name));
 
-        auto app = host_model.resolve_app_name_by_wu(QString::fromStdString(source.wu_name));
+        auto app = host_model.resolve_app_name_by_wu(wu_name);
 
-        if (project == host_model.projects.cend() || app_version == host_model.app_versions.cend() || !app.isValid())
+        if (project == nullptr || app_version == nullptr || !app.isValid())
             return {};
 
         dest.application = app.toString();
@@ -841,9 +891,9 @@ QVariant ModelHandler::map_(woinc::Tasks wtasks, const HostModel &host_model) {
         dest.project     = project->name;
         dest.project_url = QString::fromStdString(source.project_url);
         dest.resources   = QString::fromStdString(source.resources);
-        dest.status      = resolve_task_status(source, host_model.cc_status, project->non_cpu_intensive);
+        dest.status      = task_status_resolver_.resolve(source, host_model.cc_status, project->non_cpu_intensive);
         dest.task_name   = QString::fromStdString(source.name);
-        dest.wu_name     = QString::fromStdString(source.wu_name);
+        dest.wu_name     = wu_name;
 
         dest.active_task = source.active_task != nullptr;
         dest.suspended   = source.suspended_via_gui;
@@ -885,13 +935,6 @@ QVariant ModelHandler::map_(woinc::Tasks wtasks, const HostModel &host_model) {
         tasks.push_back(std::move(dest));
     }
 
-    // ensure the tasks are always in the same order
-    std::sort(tasks.begin(), tasks.end(), [](const Task &a, const Task &b) {
-        int result = compare(a, b);
-        assert(result != 0);
-        return result < 0;
-    });
-
     return QVariant::fromValue(std::move(tasks));
 }
 
@@ -19,18 +19,33 @@
 #ifndef WOINC_UI_QT_MODEL_HANDLER_H_
 #define WOINC_UI_QT_MODEL_HANDLER_H_
 
+#include <list>
 #include <map>
+#include <memory>
 #include <string>
 
+#include <QHash>
+#include <QPair>
 #include <QString>
+#include <QTemporaryDir>
 #include <QVariant>
 
 #include <woinc/types.h>
 
+#include "qt/event_store.h"
 #include "qt/model.h"
+#include "qt/search_index.h"
+#include "qt/task_status.h"
 
 namespace woinc { namespace ui { namespace qt {
 
+/*
+ * Maps the entities of libui into the types of the GUI.
+ *
+ * The handler is supposed to live in its own thread to keep the mapping out of the GUI thread,
+ * so the slots must be connected via queued connections and the widgets receive the mapped
+ * entities via queued signals.
+ */
 class ModelHandler : public Model {
     Q_OBJECT
 
@@ -48,15 +63,15 @@ class ModelHandler : public Model {
         void add_host(QString host);
         void remove_host(QString host);
 
-        void update_cc_status(QString host, woinc::CCStatus cc_status);
-        void update_client_state(QString host, woinc::ClientState client_state);
-        void update_disk_usage(QString host, woinc::DiskUsage disk_usage);
-        void update_file_transfers(QString host, woinc::FileTransfers file_transfers);
-        void update_notices(QString host, woinc::Notices notices, bool refreshed);
-        void update_messages(QString host, woinc::Messages messages);
-        void update_projects(QString host, woinc::Projects projects);
-        void update_statistics(QString host, woinc::Statistics statistics);
-        void update_tasks(QString host, woinc::Tasks tasks);
+        void update_cc_status(QString host, std::shared_ptr<const woinc::CCStatus> cc_status);
+        void update_client_state(QString host, std::shared_ptr<const woinc::ClientState> client_state);
+        void update_disk_usage(QString host, std::shared_ptr<const woinc::DiskUsage> disk_usage);
+        void update_file_transfers(QString host, std::shared_ptr<const woinc::FileTransfers> file_transfers);
+        void update_notices(QString host, std::shared_ptr<const woinc::Notices> notices, bool refreshed);
+        void update_messages(QString host, std::shared_ptr<const woinc::Messages> messages);
+        void update_projects(QString host, std::shared_ptr<const woinc::Projects> projects);
+        void update_statistics(QString host, std::shared_ptr<const woinc::Statistics> statistics);
+        void update_tasks(QString host, std::shared_ptr<const woinc::Tasks> tasks);
 
         void select_host(QString host);
         void unselect_host(QString host);
@@ -70,6 +85,9 @@ class ModelHandler : public Model {
 
     private:
         struct HostModel {
+            // (project url, app name)
+            typedef QPair<QString, QString> AppKey;
+
             const QString host;
             AppVersions app_versions;
             Apps apps;
@@ -77,35 +95,99 @@ class ModelHandler : public Model {
             Tasks tasks;
             Workunits wus;
             woinc::CCStatus cc_status;
+            // all events received in this session, kept on disk instead of in memory
+            std::shared_ptr<EventStore> events;
+            // all notices since the last refresh
+            Notices notices;
+            // the events respectively notices in the same order
+            std::shared_ptr<SearchIndex> event_index;
+            std::shared_ptr<SearchIndex> notice_index;
+
+            // the latest entities as received, kept to map them lazily, see ModelHandler::mapped_hosts_
+            struct {
+                std::shared_ptr<const woinc::CCStatus> cc_status;
+                std::shared_ptr<const woinc::ClientState> client_state;
+                std::shared_ptr<const woinc::DiskUsage> disk_usage;
+                std::shared_ptr<const woinc::FileTransfers> file_transfers;
+                std::shared_ptr<const woinc::Projects> projects;
+                std::shared_ptr<const woinc::Statistics> statistics;
+                std::shared_ptr<const woinc::Tasks> tasks;
+            } raw;
+
+            // which of the mapped entities above are outdated compared to the raw ones
+            struct {
+                bool client_state = false;
+                bool projects = false;
+                bool tasks = false;
+            } stale;
 
             explicit HostModel(const QString &host);
 
+            // drops the mapped entities, which are mapped again from the raw ones when needed
+            void release();
+
+            // must be called after modifying the entities to keep the indexes in sync
+            void reindex_client_state();
+            void reindex_projects();
+
+            const AppVersion *find_app_version(const AppKey &key) const;
+            const Project *find_project(const QString &project_url) const;
+            const Workunit *find_wu(const QString &wu_name) const;
+
             QVariant resolve_app_name_by_wu(const QString &wu_name) const;
             QVariant resolve_project_name_by_url(const std::string &master_url) const;
+
+            private:
+                void reindex_app_names_();
+
+                // the indexes into the vectors above
+                QHash<AppKey, size_t> app_index_;
+                QHash<AppKey, size_t> app_version_index_;
+                QHash<QString, size_t> project_index_;
+                QHash<QString, size_t> wu_index_;
+
+                QHash<AppKey, QString> app_names_;
         };
 
         void select_host_(const QString &host);
         void unselect_host_(const QString &host);
 
+        bool is_mapped_(const QString &host) const;
+        void touch_(const QString &host);
+        // returns false if the tasks couldn't be mapped, i.e. the client state is outdated
+        bool map_stale_(HostModel &host_model);
+
+        // updates drained by the adapter right before the host was removed may arrive afterwards
+        bool known_host_(const QString &host) const;
+
         const HostModel &find_host_model_(const QString &host) const;
         HostModel &find_host_model_(const QString &host);
 
     private:
-        Apps          map_(woinc::Apps apps);
-        AppVersions   map_(woinc::AppVersions app_versions);
-        QVariant      map_(woinc::DiskUsage disk_usage, const HostModel &host_model);
-        FileTransfers map_(woinc::FileTransfers file_transfers, const HostModel &host_model);
-        Events        map_(woinc::Messages messages);
-        Notices       map_(woinc::Notices notices);
-        Workunits     map_(woinc::Workunits workunits);
-        Projects      map_(woinc::Projects projects);
+        Apps          map_(const woinc::Apps &apps);
+        AppVersions   map_(const woinc::AppVersions &app_versions);
+        QVariant      map_(const woinc::DiskUsage &disk_usage, const HostModel &host_model);
+        FileTransfers map_(const woinc::FileTransfers &file_transfers, const HostModel &host_model);
+        Events        map_(const woinc::Messages &messages);
+        Notices       map_(const woinc::Notices &notices);
+        Workunits     map_(const woinc::Workunits &workunits);
+        Projects      map_(const woinc::Projects &projects);
         RunModes      map_(const woinc::CCStatus &cc_status);
-        QVariant      map_(woinc::Statistics statistics, const HostModel &host_model);
-        QVariant      map_(woinc::Tasks tasks, const HostModel &host_model);
+        QVariant      map_(const woinc::Statistics &statistics, const HostModel &host_model);
+        QVariant      map_(const woinc::Tasks &tasks, const HostModel &host_model);
 
     private:
         QString selected_host_;
         std::map<QString, HostModel> host_models_;
+        // the recently selected hosts, most recent first, whose entities are mapped on every update;
+        // the other hosts keep the raw entities only until they are selected again
+        std::list<QString> mapped_hosts_;
+
+        // holds the files of the event stores of all hosts during the session
+        QTemporaryDir events_dir_;
+        int num_event_stores_ = 0;
+
+        TaskStatusResolver task_status_resolver_;
 };
 
 }}}
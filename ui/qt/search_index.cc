@@ -0,0 +1,223 @@
+/* ui/qt/search_index.cc --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#include "qt/search_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace woinc { namespace ui { namespace qt {
+
+#define WOINC_LOCK_GUARD std::lock_guard<decltype(lock_)> guard(lock_)
+
+// ---- SearchQuery ----
+
+bool SearchQuery::empty() const {
+    return tokens.isEmpty() && prefixes.isEmpty() && project.isEmpty() && from == 0 && to == 0;
+}
+
+SearchQuery SearchQuery::parse(const QString &text) {
+    SearchQuery query;
+
+    for (const auto &term : text.split(QChar::fromLatin1(' '), QString::SkipEmptyParts)) {
+        auto tokens = SearchIndex::tokenize(term);
+        if (tokens.isEmpty())
+            continue;
+        // only the last token of e.g. "foo-ba*" is a prefix
+        if (term.endsWith(QChar::fromLatin1('*')))
+            query.prefixes << tokens.takeLast();
+        query.tokens << tokens;
+    }
+
+    query.tokens.removeDuplicates();
+    query.prefixes.removeDuplicates();
+
+    return query;
+}
+
+// ---- SearchIndex ----
+
+int SearchIndex::add(const QString &project, time_t timestamp, const QString &text, bool html) {
+    auto tokens = tokenize(text, html);
+    tokens.removeDuplicates();
+
+    WOINC_LOCK_GUARD;
+
+    const int id = static_cast<int>(documents_.size());
+
+    int project_id = project_ids_.value(project, -1);
+    if (project_id < 0) {
+        project_id = projects_.size();
+        project_ids_.insert(project, project_id);
+        projects_ << project;
+        project_postings_.emplace_back();
+    }
+
+    documents_.push_back({static_cast<qint64>(timestamp), project_id});
+    project_postings_[static_cast<size_t>(project_id)].push_back(id);
+
+    for (const auto &token : tokens)
+        tokens_[token].push_back(id);
+
+    return id;
+}
+
+int SearchIndex::size() const {
+    WOINC_LOCK_GUARD;
+    return static_cast<int>(documents_.size());
+}
+
+QStringList SearchIndex::projects() const {
+    WOINC_LOCK_GUARD;
+    return projects_;
+}
+
+std::vector<int> SearchIndex::find(const SearchQuery &query, int first_id) const {
+    WOINC_LOCK_GUARD;
+
+    const int first = std::max(first_id, 0);
+    if (first >= static_cast<int>(documents_.size()))
+        return {};
+
+    // the ascending ids of each term, all of them must contain a matching document
+    std::vector<const Postings *> lists;
+
+    for (const auto &token : query.tokens) {
+        auto iter = tokens_.find(token);
+        if (iter == tokens_.end())
+            return {};
+        lists.push_back(&iter->second);
+    }
+
+    // a prefix matches the union of the postings of all tokens starting with it
+    std::vector<Postings> unions;
+    unions.reserve(static_cast<size_t>(query.prefixes.size()));
+
+    for (const auto &prefix : query.prefixes) {
+        auto begin = tokens_.lower_bound(prefix);
+        auto end = begin;
+        while (end != tokens_.end() && end->first.startsWith(prefix))
+            ++end;
+
+        if (begin == end)
+            return {};
+
+        if (std::next(begin) == end) {
+            lists.push_back(&begin->second);
+            continue;
+        }
+
+        // merging the postings via a bitmap is linear in the number of documents
+        std::vector<char> contained(documents_.size() - static_cast<size_t>(first), 0);
+        for (auto iter = begin; iter != end; ++iter)
+            for (auto id = std::lower_bound(iter->second.begin(), iter->second.end(), first); id != iter->second.end(); ++id)
+                contained[static_cast<size_t>(*id - first)] = 1;
+
+        Postings postings;
+        for (size_t i = 0; i < contained.size(); ++i)
+            if (contained[i])
+                postings.push_back(first + static_cast<int>(i));
+
+        unions.push_back(std::move(postings));
+        lists.push_back(&unions.back());
+    }
+
+    if (!query.project.isEmpty()) {
+        const int project_id = project_ids_.value(query.project, -1);
+        if (project_id < 0)
+            return {};
+        lists.push_back(&project_postings_[static_cast<size_t>(project_id)]);
+    }
+
+    const qint64 from = static_cast<qint64>(query.from);
+    const qint64 to = static_cast<qint64>(query.to);
+
+    auto in_time_range = [&](int id) {
+        const auto timestamp = documents_[static_cast<size_t>(id)].timestamp;
+        return (from == 0 || timestamp >= from) && (to == 0 || timestamp <= to);
+    };
+
+    std::vector<int> result;
+
+    if (lists.empty()) {
+        for (int id = first; id < static_cast<int>(documents_.size()); ++id)
+            if (in_time_range(id))
+                result.push_back(id);
+        return result;
+    }
+
+    // walk the shortest list and skip ahead in the others
+    std::sort(lists.begin(), lists.end(), [](const Postings *a, const Postings *b) {
+        return a->size() < b->size();
+    });
+
+    std::vector<Postings::const_iterator> cursors;
+    cursors.reserve(lists.size());
+    for (auto list : lists)
+        cursors.push_back(std::lower_bound(list->begin(), list->end(), first));
+
+    for (; cursors[0] != lists[0]->end(); ++cursors[0]) {
+        const int id = *cursors[0];
+        bool matches = true;
+
+        for (size_t i = 1; matches && i < lists.size(); ++i) {
+            cursors[i] = std::lower_bound(cursors[i], lists[i]->end(), id);
+            if (cursors[i] == lists[i]->end())
+                return result;
+            matches = *cursors[i] == id;
+        }
+
+        if (matches && in_time_range(id))
+            result.push_back(id);
+    }
+
+    return result;
+}
+
+QStringList SearchIndex::tokenize(const QString &text, bool html) {
+    QStringList tokens;
+    QString token;
+    bool in_tag = false;
+
+    for (const QChar c : text) {
+        if (in_tag) {
+            in_tag = c != QChar::fromLatin1('>');
+            continue;
+        }
+
+        if (c.isLetterOrNumber()) {
+            token += c.toLower();
+            continue;
+        }
+
+        in_tag = html && c == QChar::fromLatin1('<');
+
+        if (!token.isEmpty()) {
+            tokens << token;
+            token.clear();
+        }
+    }
+
+    if (!token.isEmpty())
+        tokens << token;
+
+    return tokens;
+}
+
+}}}
@@ -0,0 +1,105 @@
+/* ui/qt/search_index.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#ifndef WOINC_UI_QT_SEARCH_INDEX_H_
+#define WOINC_UI_QT_SEARCH_INDEX_H_
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QHash>
+#include <QMetaType>
+#include <QString>
+#include <QStringList>
+
+namespace woinc { namespace ui { namespace qt {
+
+struct SearchQuery {
+    QStringList tokens;   // must be contained as a whole
+    QStringList prefixes; // a token starting with each of these must be contained
+    QString project;      // all projects if empty
+    time_t from = 0;      // unbounded if 0
+    time_t to = 0;        // unbounded if 0
+
+    bool empty() const;
+
+    // parses the terms of a query, e.g. "upload fail*" matches all documents containing "upload" and
+    // a token starting with "fail"
+    static SearchQuery parse(const QString &text);
+};
+
+/*
+ * An incremental inverted index over documents with a project and a timestamp.
+ *
+ * The documents are numbered in the order they are added, e.g. the rows of an event store. Each
+ * token maps to the ascending ids of the documents containing it, so a query is answered by
+ * intersecting these lists instead of scanning the texts. The tokens are kept sorted to answer
+ * prefix queries by a range of them.
+ *
+ * The index is threadsafe, documents may be added while querying it.
+ */
+class SearchIndex {
+    public:
+        SearchIndex() = default;
+
+        SearchIndex(const SearchIndex &) = delete;
+        SearchIndex(SearchIndex &&) = delete;
+
+        SearchIndex &operator=(const SearchIndex &) = delete;
+        SearchIndex &operator=(SearchIndex &&) = delete;
+
+        // returns the id of the added document; markup in the text, i.e. HTML tags, is skipped if html is set
+        int add(const QString &project, time_t timestamp, const QString &text, bool html = false);
+
+        int size() const;
+        QStringList projects() const;
+
+        // the ascending ids, not less than first_id, of the documents matching the query
+        std::vector<int> find(const SearchQuery &query, int first_id = 0) const;
+
+        // the lower-cased tokens of the text
+        static QStringList tokenize(const QString &text, bool html = false);
+
+    private:
+        typedef std::vector<int> Postings;
+
+        struct Document {
+            qint64 timestamp;
+            int project;
+        };
+
+    private:
+        mutable std::mutex lock_;
+
+        std::map<QString, Postings> tokens_;
+        std::vector<Postings> project_postings_;
+        std::vector<Document> documents_;
+
+        QHash<QString, int> project_ids_;
+        QStringList projects_;
+};
+
+}}}
+
+Q_DECLARE_METATYPE(std::shared_ptr<const woinc::ui::qt::SearchIndex>)
+
+#endif
@@ -18,18 +18,18 @@
 
 #include "qt/tabs/events_tab.h"
 
-#include <deque>
+#include <algorithm>
 #ifndef NDEBUG
 #include <iostream>
 #endif
 
 #include <QFontMetrics>
-#include <QHBoxLayout>
 #include <QHeaderView>
 #include <QScrollBar>
+#include <QVBoxLayout>
 
+#include "qt/tabs/filter_bar.h"
 #include "qt/tabs/proxy_models.h"
-#include "qt/tabs/tab_model_updater.h"
 #include "qt/utils.h"
 
 namespace {
@@ -41,8 +41,7 @@ enum {
 };
 
 enum {
-    COLUMN_COUNT = 3,
-    MAX_NUM_EVENTS = 2000
+    COLUMN_COUNT = 3
 };
 
 }
@@ -51,12 +50,12 @@ namespace woinc { namespace ui { namespace qt { namespace events_tab_internals {
 
 // ------- TabModel -------
 
-TabModel::TabModel(QObject *parent) : QAbstractTableModel(parent) {
-    events_.reserve(MAX_NUM_EVENTS);
-}
+TabModel::TabModel(QObject *parent) : QAbstractTableModel(parent) {}
 
 int TabModel::rowCount(const QModelIndex &parent) const {
-    return parent.isValid() ? 0 : static_cast<int>(events_.size());
+    if (parent.isValid())
+        return 0;
+    return filtered_ ? static_cast<int>(matches_.size()) : rows_;
 }
 
 int TabModel::columnCount(const QModelIndex &parent) const {
@@ -71,11 +70,9 @@ QVariant TabModel::data(const QModelIndex &index, int role) const {
         return Qt::AlignLeft + Qt::AlignVCenter;
 
     assert(index.row() >= 0);
+    assert(index.row() < rowCount());
 
-    auto row = static_cast<Events::size_type>(index.row());
-    assert(row < events_.size());
-
-    const auto &event = events_.at(row);
+    const auto &event = event_(index.row());
 
     // TODO how to choose a proper color when themes are used?
     if (role == Qt::ForegroundRole && event.user_alert)
@@ -113,32 +110,76 @@ QVariant TabModel::headerData(int section, Qt::Orientation orientation, int role
     return QVariant();
 }
 
-void TabModel::select_host(QString /*host*/) {
-    events_.clear();
-    append_events({});
+QStringList TabModel::projects() const {
+    return index_ ? index_->projects() : QStringList();
 }
 
-void TabModel::unselect_host(QString /*host*/) {
-    events_.clear();
-    append_events({});
+void TabModel::select_events(std::shared_ptr<const EventStore> events, std::shared_ptr<const SearchIndex> index) {
+    beginResetModel();
+    store_ = std::move(events);
+    index_ = std::move(index);
+    rows_ = store_ ? store_->size() : 0;
+    matches_ = filtered_ ? find_(0) : std::vector<int>();
+    cached_row_ = -1;
+    endResetModel();
+
+    emit updated();
 }
 
-void TabModel::append_events(Events new_events) {
-    std::deque<Event> events;
-    events.insert(events.end(), events_.begin(), events_.end());
-    events.insert(events.end(), new_events.begin(), new_events.end());
+void TabModel::append_events(int num_events) {
+    // the store may have grown further since the signal was emitted
+    if (num_events <= rows_ || !store_)
+        return;
+
+    if (filtered_) {
+        const int first = rows_;
+        rows_ = num_events;
 
-    while (events.size() > MAX_NUM_EVENTS)
-        events.pop_front();
+        auto matches = find_(first);
+        if (matches.empty())
+            return;
 
-    update_tab_model(*this,
-                     events_,
-                     std::move(events),
-                     [](const Event &a, const Event &b) { return a.seqno - b.seqno; });
+        const int num_matches = static_cast<int>(matches_.size());
+        beginInsertRows(QModelIndex(), num_matches, num_matches + static_cast<int>(matches.size()) - 1);
+        matches_.insert(matches_.end(), matches.begin(), matches.end());
+        endInsertRows();
+    } else {
+        beginInsertRows(QModelIndex(), rows_, num_events - 1);
+        rows_ = num_events;
+        endInsertRows();
+    }
 
     emit updated();
 }
 
+void TabModel::filter(SearchQuery query) {
+    beginResetModel();
+    query_ = std::move(query);
+    filtered_ = !query_.empty();
+    matches_ = filtered_ ? find_(0) : std::vector<int>();
+    cached_row_ = -1;
+    endResetModel();
+
+    emit updated();
+}
+
+const Event &TabModel::event_(int row) const {
+    if (row != cached_row_) {
+        cached_event_ = store_->at(filtered_ ? matches_[static_cast<size_t>(row)] : row);
+        cached_row_ = row;
+    }
+    return cached_event_;
+}
+
+std::vector<int> TabModel::find_(int first) const {
+    if (!index_)
+        return {};
+
+    auto matches = index_->find(query_, first);
+    matches.erase(std::lower_bound(matches.begin(), matches.end(), rows_), matches.end());
+    return matches;
+}
+
 // ------- TableView -------
 
 TableView::TableView(TabModel *model, QWidget *parent)
@@ -192,28 +233,28 @@ void TableView::adjust_scrolling_(int value) {
 EventsTab::EventsTab(QWidget *parent) : QWidget(parent) {
     using namespace woinc::ui::qt::events_tab_internals;
 
-    auto tab_model = new TabModel(this);
-    auto view = new TableView(tab_model, this);
+    tab_model_ = new TabModel(this);
+    filter_bar_ = new FilterBar(this);
+    auto view = new TableView(tab_model_, this);
 
-    auto layout = new QHBoxLayout;
+    auto layout = new QVBoxLayout;
+    layout->addWidget(filter_bar_);
     layout->addWidget(view);
     setLayout(layout);
 
-    connect(this, &EventsTab::events_appended, tab_model, &TabModel::append_events);
-    connect(this, &EventsTab::host_selected,   tab_model, &TabModel::select_host);
-    connect(this, &EventsTab::host_unselected, tab_model, &TabModel::unselect_host);
-}
-
-void EventsTab::append_events(Events events) {
-    emit events_appended(events);
+    connect(filter_bar_, &FilterBar::query_changed, this, [this]() {
+        tab_model_->filter(filter_bar_->query());
+    });
 }
 
-void EventsTab::select_host(QString host) {
-    emit host_selected(host);
+void EventsTab::select_events(std::shared_ptr<const EventStore> events, std::shared_ptr<const SearchIndex> index) {
+    tab_model_->select_events(std::move(events), std::move(index));
+    filter_bar_->set_projects(tab_model_->projects());
 }
 
-void EventsTab::unselect_host(QString host) {
-    emit host_unselected(host);
+void EventsTab::append_events(int num_events) {
+    tab_model_->append_events(num_events);
+    filter_bar_->set_projects(tab_model_->projects());
 }
 
 }}}
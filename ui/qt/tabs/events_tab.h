@@ -19,19 +19,20 @@
 #ifndef WOINC_UI_QT_EVENTS_TAB_H_
 #define WOINC_UI_QT_EVENTS_TAB_H_
 
+#include <memory>
+#include <vector>
+
 #include <QAbstractTableModel>
 #include <QTableView>
 #include <QWidget>
 
+#include "qt/event_store.h"
+#include "qt/search_index.h"
 #include "qt/types.h"
 
 namespace woinc { namespace ui { namespace qt {
 
-template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename DATA_ITEM_COMP>
-void update_tab_model(TAB_MODEL &model,
-                      TARGET_CONTAINER &current_data,
-                      SOURCE_CONTAINER new_data,
-                      DATA_ITEM_COMP comp);
+class FilterBar;
 
 namespace events_tab_internals {
 
@@ -54,24 +55,35 @@ class TabModel : public QAbstractTableModel {
         QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const final;
         QVariant headerData(int section, Qt::Orientation orientation, int role) const final;
 
-    public:
-        template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename DATA_ITEM_COMP>
-        friend void woinc::ui::qt::update_tab_model(TAB_MODEL &model,
-                                                    TARGET_CONTAINER &current_data,
-                                                    SOURCE_CONTAINER new_data,
-                                                    DATA_ITEM_COMP comp);
+        QStringList projects() const;
 
     public slots:
-        void append_events(Events events);
-        void select_host(QString host);
-        void unselect_host(QString host);
+        void select_events(std::shared_ptr<const EventStore> events, std::shared_ptr<const SearchIndex> index);
+        void append_events(int num_events);
+        void filter(SearchQuery query);
 
     signals:
         void updated();
 
     private:
-        // TODO use a deque instead of a vector as we want to only hold x events, not all of them
-        Events events_;
+        const Event &event_(int row) const;
+        // the matching events in [first, rows_), the index may already contain newer ones
+        std::vector<int> find_(int first) const;
+
+    private:
+        // the rows are read from the store on demand, so only the visible events are held in memory
+        std::shared_ptr<const EventStore> store_;
+        std::shared_ptr<const SearchIndex> index_;
+        int rows_ = 0;
+
+        // the events of the store shown if filtered
+        bool filtered_ = false;
+        SearchQuery query_;
+        std::vector<int> matches_;
+
+        // the views request the columns of a row one after another, so the last read event is cached
+        mutable int cached_row_ = -1;
+        mutable Event cached_event_;
 };
 
 class TableView : public QTableView {
@@ -111,14 +123,12 @@ class EventsTab : public QWidget {
         EventsTab &operator=(EventsTab &&) = delete;
 
     public slots:
-        void append_events(Events events);
-        void select_host(QString host);
-        void unselect_host(QString host);
+        void select_events(std::shared_ptr<const EventStore> events, std::shared_ptr<const SearchIndex> index);
+        void append_events(int num_events);
 
-    signals:
-        void events_appended(Events events);
-        void host_selected(QString host);
-        void host_unselected(QString host);
+    private:
+        events_tab_internals::TabModel *tab_model_;
+        FilterBar *filter_bar_;
 };
 
 }}}
@@ -0,0 +1,119 @@
+/* ui/qt/tabs/filter_bar.cc --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#include "qt/tabs/filter_bar.h"
+
+#include <algorithm>
+#include <ctime>
+
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QLineEdit>
+
+namespace {
+
+struct TimeRange {
+    const char *name;
+    time_t seconds;
+};
+
+const TimeRange TIME_RANGES[] = {
+    { "Any time",      0 },
+    { "Last hour",     60 * 60 },
+    { "Last 24 hours", 24 * 60 * 60 },
+    { "Last 7 days",   7 * 24 * 60 * 60 },
+    { "Last 30 days",  30 * 24 * 60 * 60 }
+};
+
+}
+
+namespace woinc { namespace ui { namespace qt {
+
+FilterBar::FilterBar(QWidget *parent)
+    : QWidget(parent)
+    , terms_(new QLineEdit(this))
+    , project_(new QComboBox(this))
+    , time_range_(new QComboBox(this))
+{
+    terms_->setClearButtonEnabled(true);
+    terms_->setPlaceholderText(QString::fromUtf8("Search, e.g. \"upload fail*\""));
+
+    project_->addItem(QString::fromUtf8("All projects"));
+    project_->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+
+    for (const auto &range : TIME_RANGES)
+        time_range_->addItem(QString::fromUtf8(range.name));
+
+    auto layout = new QHBoxLayout;
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(terms_, 1);
+    layout->addWidget(project_);
+    layout->addWidget(time_range_);
+    setLayout(layout);
+
+    connect(terms_, &QLineEdit::textChanged, this, &FilterBar::update_query_);
+    connect(project_, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            this, &FilterBar::update_query_);
+    connect(time_range_, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            this, &FilterBar::update_query_);
+}
+
+const SearchQuery &FilterBar::query() const {
+    return query_;
+}
+
+void FilterBar::set_projects(QStringList projects) {
+    projects.removeAll(QString());
+    std::sort(projects.begin(), projects.end(), [](const QString &a, const QString &b) {
+        return a.localeAwareCompare(b) < 0;
+    });
+
+    if (projects == projects_)
+        return;
+    projects_ = std::move(projects);
+
+    const auto selected = project_->currentIndex() > 0 ? project_->currentText() : QString();
+
+    project_->blockSignals(true);
+    while (project_->count() > 1)
+        project_->removeItem(project_->count() - 1);
+    project_->addItems(projects_);
+    project_->setCurrentIndex(std::max(0, project_->findText(selected)));
+    project_->blockSignals(false);
+
+    // the selected project isn't contained anymore, e.g. after selecting another host
+    if (!selected.isEmpty() && project_->currentIndex() == 0)
+        update_query_();
+}
+
+void FilterBar::update_query_() {
+    auto query = SearchQuery::parse(terms_->text());
+
+    if (project_->currentIndex() > 0)
+        query.project = project_->currentText();
+
+    const auto range = TIME_RANGES[std::max(0, time_range_->currentIndex())].seconds;
+    if (range > 0)
+        query.from = std::time(nullptr) - range;
+
+    query_ = std::move(query);
+    emit query_changed();
+}
+
+}}}
@@ -0,0 +1,70 @@
+/* ui/qt/tabs/filter_bar.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#ifndef WOINC_UI_QT_TABS_FILTER_BAR_H_
+#define WOINC_UI_QT_TABS_FILTER_BAR_H_
+
+#include <QStringList>
+#include <QWidget>
+
+#include "qt/search_index.h"
+
+class QComboBox;
+class QLineEdit;
+
+namespace woinc { namespace ui { namespace qt {
+
+// the input of a query for a search index: the terms, a project and a time range
+class FilterBar : public QWidget {
+    Q_OBJECT
+
+    public:
+        FilterBar(QWidget *parent = nullptr);
+        virtual ~FilterBar() = default;
+
+        FilterBar(const FilterBar &) = delete;
+        FilterBar &operator=(const FilterBar &) = delete;
+
+        FilterBar(FilterBar &&) = delete;
+        FilterBar &operator=(FilterBar &&) = delete;
+
+        const SearchQuery &query() const;
+
+    public slots:
+        // keeps the selected project if it's still contained
+        void set_projects(QStringList projects);
+
+    signals:
+        void query_changed();
+
+    private:
+        void update_query_();
+
+    private:
+        QLineEdit *terms_;
+        QComboBox *project_;
+        QComboBox *time_range_;
+
+        QStringList projects_;
+        SearchQuery query_;
+};
+
+}}}
+
+#endif
@@ -28,14 +28,19 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QUrl>
+#include <QVBoxLayout>
 
-namespace woinc { namespace ui { namespace qt {
+#include "qt/tabs/filter_bar.h"
 
-NoticesTab::NoticesTab(QWidget *parent) : QTextBrowser(parent), network_manager_(new QNetworkAccessManager(this)) {
+namespace woinc { namespace ui { namespace qt { namespace notices_tab_internals {
+
+// ------- Browser -------
+
+Browser::Browser(QWidget *parent) : QTextBrowser(parent), network_manager_(new QNetworkAccessManager(this)) {
     setOpenExternalLinks(true);
 }
 
-QVariant NoticesTab::loadResource(int type, const QUrl &name) {
+QVariant Browser::loadResource(int type, const QUrl &name) {
     if (type == QTextDocument::ImageResource) {
         static std::map<QUrl, QImage> cache;
 
@@ -65,29 +70,56 @@ QVariant NoticesTab::loadResource(int type, const QUrl &name) {
     return QTextBrowser::loadResource(type, name);
 }
 
-void NoticesTab::select_host(QString /*host*/) {
-    notices_.clear();
-}
+} // internals
+
+// ------- NoticesTab -------
 
-void NoticesTab::unselect_host(QString /*host*/) {
-    notices_.clear();
+NoticesTab::NoticesTab(QWidget *parent)
+    : QWidget(parent)
+    , filter_bar_(new FilterBar(this))
+    , browser_(new notices_tab_internals::Browser(this))
+{
+    auto layout = new QVBoxLayout;
+    layout->addWidget(filter_bar_);
+    layout->addWidget(browser_);
+    setLayout(layout);
+
+    connect(filter_bar_, &FilterBar::query_changed, this, &NoticesTab::update_);
 }
 
 void NoticesTab::append_notices(Notices notices) {
     notices_.insert(notices_.end(), notices.begin(), notices.end());
+    if (index_)
+        filter_bar_->set_projects(index_->projects());
     update_();
 }
 
-void NoticesTab::refresh_notices(Notices notices) {
+void NoticesTab::refresh_notices(Notices notices, std::shared_ptr<const SearchIndex> index) {
     notices_ = std::move(notices);
+    index_ = std::move(index);
+    filter_bar_->set_projects(index_ ? index_->projects() : QStringList());
     update_();
 }
 
 void NoticesTab::update_() {
+    std::vector<Notices::size_type> shown;
+
+    if (!index_ || filter_bar_->query().empty()) {
+        shown.resize(notices_.size());
+        for (Notices::size_type i = 0; i < shown.size(); ++i)
+            shown[i] = i;
+    } else {
+        // the index may already contain notices not yet appended to the tab
+        for (auto id : index_->find(filter_bar_->query()))
+            if (static_cast<Notices::size_type>(id) < notices_.size())
+                shown.push_back(static_cast<Notices::size_type>(id));
+    }
+
     QStringList txts;
-    txts.reserve(static_cast<int>(notices_.size()));
+    txts.reserve(static_cast<int>(shown.size()));
 
-    for (auto notice = notices_.rbegin(); notice != notices_.rend(); ++notice) {
+    for (auto i = shown.rbegin(); i != shown.rend(); ++i) {
+        const auto notice = &notices_[*i];
         QString title;
 
         switch (notice->category) {
@@ -114,7 +146,7 @@ void NoticesTab::update_() {
         txts <<  "<b>" + title + "</b><br>" + notice->description + footer;
     }
 
-    setHtml("<html><head></head><body>" + txts.join("<hr>") + "</body></html>");
+    browser_->setHtml("<html><head></head><body>" + txts.join("<hr>") + "</body></html>");
 }
 
 }}}
@@ -19,35 +19,58 @@
 #ifndef WOINC_UI_QT_NOTICES_TAB_H_
 #define WOINC_UI_QT_NOTICES_TAB_H_
 
+#include <memory>
+
 #include <QTextBrowser>
+#include <QWidget>
 
+#include "qt/search_index.h"
 #include "qt/types.h"
 
 struct QNetworkAccessManager;
 
 namespace woinc { namespace ui { namespace qt {
 
-class NoticesTab : public QTextBrowser {
+class FilterBar;
+
+namespace notices_tab_internals {
+
+class Browser : public QTextBrowser {
     Q_OBJECT
 
     public:
-        NoticesTab(QWidget *parent = nullptr);
-        virtual ~NoticesTab() = default;
+        Browser(QWidget *parent = nullptr);
+        virtual ~Browser() = default;
 
         QVariant loadResource(int type, const QUrl &name) final;
 
+    private:
+        QNetworkAccessManager *network_manager_;
+};
+
+} // namespace notices_tab_internals
+
+class NoticesTab : public QWidget {
+    Q_OBJECT
+
+    public:
+        NoticesTab(QWidget *parent = nullptr);
+        virtual ~NoticesTab() = default;
+
     public slots:
-        void select_host(QString host);
-        void unselect_host(QString host);
         void append_notices(Notices notices);
-        void refresh_notices(Notices notices);
+        // the index contains the refreshed notices in the same order
+        void refresh_notices(Notices notices, std::shared_ptr<const SearchIndex> index);
 
     private:
         void update_();
 
     private:
         Notices notices_;
-        QNetworkAccessManager *network_manager_;
+        std::shared_ptr<const SearchIndex> index_;
+
+        FilterBar *filter_bar_;
+        notices_tab_internals::Browser *browser_;
 };
 
 }}}
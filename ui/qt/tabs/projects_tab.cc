@@ -34,6 +34,8 @@
 #include <QScrollArea>
 #include <QVBoxLayout>
 
+#include <woinc/trace.h>
+
 #include "qt/dialogs/project_properties_dialog.h"
 #include "qt/tabs/delegates.h"
 #include "qt/tabs/proxy_models.h"
@@ -56,13 +58,18 @@ enum {
     PTM_SORT_RULE = Qt::UserRole
 };
 
-int compare__(const QString &a, const QString &b) {
-    return a.localeAwareCompare(b);
-}
-
-int compare__(const woinc::ui::qt::Project &a,
-              const woinc::ui::qt::Project &b) {
-    return compare__(a.name, b.name);
+woinc::ui::qt::ColumnMask changed_columns__(const woinc::ui::qt::Project &a, const woinc::ui::qt::Project &b) {
+    using woinc::ui::qt::column_mask;
+
+    woinc::ui::qt::ColumnMask mask = 0;
+    if (a.name != b.name)                             mask |= column_mask(INDEX_PROJECT);
+    if (a.account != b.account)                       mask |= column_mask(INDEX_ACCOUNT);
+    if (a.team != b.team)                             mask |= column_mask(INDEX_TEAM);
+    if (a.user_total_credit != b.user_total_credit)   mask |= column_mask(INDEX_WORK_DONE);
+    if (a.user_expavg_credit != b.user_expavg_credit) mask |= column_mask(INDEX_AVG_WORK_DONE);
+    if (a.resource_share != b.resource_share)         mask |= column_mask(INDEX_RESOURCE_SHARE);
+    if (a.status != b.status)                         mask |= column_mask(INDEX_STATUS);
+    return mask;
 }
 
 }
@@ -311,10 +318,12 @@ void TabModel::select_projects(SelectedRows selected_rows) {
 }
 
 void TabModel::update_projects(Projects new_projects) {
+    WOINC_TRACE_SPAN("qt.update_tab_model");
     update_tab_model(*this,
                      projects_,
                      std::move(new_projects),
-                     [](const Project &a, const Project &b) { return compare__(a, b); });
+                     [](const Project &project) { return project.project_url; },
+                     &changed_columns__);
 
     emit projects_updated();
 }
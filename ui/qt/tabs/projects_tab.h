@@ -37,11 +37,12 @@
 namespace woinc { namespace ui { namespace qt {
 
 // forward declaration for usage as friend later on
-template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename DATA_ITEM_COMP>
+template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename KEY_OF, typename CHANGED_COLUMNS>
 void update_tab_model(TAB_MODEL &model,
                       TARGET_CONTAINER &current_data,
                       SOURCE_CONTAINER new_data,
-                      DATA_ITEM_COMP comp);
+                      KEY_OF key_of,
+                      CHANGED_COLUMNS changed_columns);
 
 namespace projects_tab_internals {
 
@@ -111,11 +112,12 @@ class TabModel : public QAbstractTableModel {
         QVariant headerData(int section, Qt::Orientation orientation, int role) const final;
 
     public:
-        template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename DATA_ITEM_COMP>
+        template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename KEY_OF, typename CHANGED_COLUMNS>
         friend void woinc::ui::qt::update_tab_model(TAB_MODEL &model,
                                                     TARGET_CONTAINER &current_data,
                                                     SOURCE_CONTAINER new_data,
-                                                    DATA_ITEM_COMP comp);
+                                                    KEY_OF key_of,
+                                                    CHANGED_COLUMNS changed_columns);
 
     public slots:
         void select_host(QString host);
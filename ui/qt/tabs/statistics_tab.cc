@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <limits>
 #include <set>
 #include <utility>
@@ -53,7 +54,7 @@ enum {
     LIMIT_BEFORE_SWITCH_TO_GRID = 3
 };
 
-typedef std::map<time_t, double> Stats;
+typedef QVector<QPointF> Stats;
 
 QString to_string__(StatisticType type) {
     switch (type) {
@@ -67,109 +68,110 @@ QString to_string__(StatisticType type) {
 
 Stats to_stats__(const woinc::ui::qt::DailyStatistics &daily_stats, const StatsSelector &selector) {
     Stats stats;
-    for (auto &&ds : daily_stats)
-        stats.emplace(ds.day * 1000 /*ms since epoch*/, selector(ds));
-    return stats;
-}
-
-void create_statistics_chart_axes__(QChart &chart) {
-    auto x_range = std::make_pair(std::numeric_limits<qreal>::max(), std::numeric_limits<qreal>::min());
-    auto y_range = std::make_pair(std::numeric_limits<qreal>::max(), std::numeric_limits<qreal>::min());
+    stats.reserve(static_cast<int>(daily_stats.size()));
 
-    for (const auto si : chart.series()) {
-        assert(dynamic_cast<QXYSeries *>(si));
-        auto series = static_cast<QXYSeries *>(si);
+    for (auto &&ds : daily_stats)
+        stats.append(QPointF(static_cast<qreal>(ds.day) * 1000 /*ms since epoch*/, selector(ds)));
 
-        auto points = series->pointsVector();
-        assert(!points.empty());
+    auto by_day = [](const QPointF &a, const QPointF &b) { return a.x() < b.x(); };
+    if (!std::is_sorted(stats.cbegin(), stats.cend(), by_day))
+        std::sort(stats.begin(), stats.end(), by_day);
 
-        x_range.first  = std::min(x_range.first,  points.front().x());
-        x_range.second = std::max(x_range.second, points.back().x());
+    return stats;
+}
 
-        auto tmp_y_range = std::minmax_element(points.cbegin(), points.cend(),
-                                               [](const auto &a, const auto &b) { return a.y() < b.y(); });
+// appends the days not known yet, the statistic of the last known day may have been updated meanwhile
+void merge_daily_statistics__(woinc::ui::qt::DailyStatistics &current, woinc::ui::qt::DailyStatistics &&new_stats) {
+    const auto known = current.size();
 
-        y_range.first  = std::min(y_range.first,  tmp_y_range.first->y());
-        y_range.second = std::max(y_range.second, tmp_y_range.second->y());
+    if (known == 0 || new_stats.size() < known
+            || new_stats.front().day != current.front().day
+            || new_stats[known - 1].day != current.back().day) {
+        current = std::move(new_stats);
+        return;
     }
 
-    auto x_axis = new QDateTimeAxis;
-    auto y_axis = new QValueAxis;
+    current.back() = new_stats[known - 1];
+    current.insert(current.end(), new_stats.cbegin() + static_cast<std::ptrdiff_t>(known), new_stats.cend());
+}
 
-    x_axis->setFormat("dd.MMMyy");
-    x_axis->setRange(QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(x_range.first  - MILLISECONDS_PER_DAY)),
-                     QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(x_range.second + MILLISECONDS_PER_DAY)));
+// downsamples the points, ordered by x, to the given number of points by the largest-triangle-three-buckets
+// algorithm, i.e. keeps the point of each bucket spanning the largest triangle with its neighbours
+QVector<QPointF> downsample_lttb__(const QVector<QPointF> &points, int threshold) {
+    const int size = points.size();
+    if (threshold >= size || threshold < 3)
+        return points;
 
-    auto gap = std::max((y_range.second - y_range.first) * 0.05, 1.);
-    y_range.first -= gap;
-    y_range.second += gap;
+    QVector<QPointF> sampled;
+    sampled.reserve(threshold);
+    sampled.append(points.front());
 
-    y_axis->setRange(std::max(y_range.first, 0.), y_range.second);
-    y_axis->setLabelFormat("%d");
+    // the first and the last point are kept, the others are split into buckets
+    const double bucket_size = static_cast<double>(size - 2) / (threshold - 2);
+    auto bucket_begin = [&](int bucket) { return static_cast<int>(std::floor(bucket * bucket_size)) + 1; };
 
-    chart.addAxis(x_axis, Qt::AlignBottom);
-    chart.addAxis(y_axis, Qt::AlignLeft);
+    int selected = 0;
 
-    for (const auto si : chart.series()) {
-        si->attachAxis(x_axis);
-        si->attachAxis(y_axis);
-    }
-}
+    for (int bucket = 0; bucket < threshold - 2; ++bucket) {
+        // the average of the next bucket is the third point of the triangles
+        const int next_begin = bucket_begin(bucket + 1);
+        const int next_end = std::max(std::min(bucket_begin(bucket + 2), size), next_begin + 1);
 
-QLineSeries *create_line_series__(const Stats &stats) {
-    auto series = new QLineSeries;
-    series->setPointsVisible();
+        QPointF average(0, 0);
+        for (int i = next_begin; i < next_end; ++i)
+            average += points[i];
+        average /= next_end - next_begin;
 
-    for (const auto &s : stats)
-        series->append(static_cast<qreal>(s.first), s.second);
+        const QPointF &a = points[selected];
+        double max_area = -1;
 
-    return series;
-}
+        for (int i = bucket_begin(bucket); i < next_begin; ++i) {
+            const QPointF &b = points[i];
+            const double area = std::abs((a.x() - average.x()) * (b.y() - a.y()) - (a.x() - b.x()) * (average.y() - a.y()));
+            if (area > max_area) {
+                max_area = area;
+                selected = i;
+            }
+        }
 
-void update_chart__(QChart *chart, const Stats &stats, const QString &title = QString()) {
-    chart->removeAllSeries();
-    for (auto axis : chart->axes()) {
-        chart->removeAxis(axis);
-        delete axis;
+        sampled.append(points[selected]);
     }
 
-    chart->setTitle(title);
-    chart->addSeries(create_line_series__(stats));
-    create_statistics_chart_axes__(*chart);
-}
-
-void update_chart__(QChart *chart, const std::vector<Stats> &stats, const QString &title = QString()) {
-    chart->removeAllSeries();
-    for (auto axis : chart->axes()) {
-        chart->removeAxis(axis);
-        delete axis;
-    }
+    sampled.append(points.back());
 
-    chart->setTitle(title);
-    for (const auto &s : stats)
-        chart->addSeries(create_line_series__(s));
-    create_statistics_chart_axes__(*chart);
+    return sampled;
 }
 
 Stats sum_stats(const std::vector<Stats> &all_stats) {
-    Stats summed_stats;
+    std::map<qreal, double> summed_stats;
 
     for (const auto &stats : all_stats)
-        for (const auto &day_entry : stats)
-            summed_stats[day_entry.first] = 0;
+        for (const auto &point : stats)
+            summed_stats[point.x()] = 0;
 
     // TODO maybe we should interpolate instead of just using the last known value to fill the gaps
     for (const auto &stats : all_stats) {
-        auto value = stats.begin()->second;
+        if (stats.isEmpty())
+            continue;
+
+        auto point = stats.cbegin();
+        auto value = point->y();
+
         for (auto &day_entry : summed_stats) {
-            auto iter = stats.find(day_entry.first);
-            if (iter != stats.end())
-                value = iter->second;
+            if (point != stats.cend() && point->x() == day_entry.first) {
+                value = point->y();
+                ++point;
+            }
             day_entry.second += value;
         }
     }
 
-    return summed_stats;
+    Stats stats;
+    stats.reserve(static_cast<int>(summed_stats.size()));
+    for (const auto &day_entry : summed_stats)
+        stats.append(QPointF(day_entry.first, day_entry.second));
+
+    return stats;
 }
 
 } // unnamed namespace
@@ -208,12 +210,12 @@ QStringList TabState::selected_projects() const {
     return list;
 }
 
-ProjectStatistics TabState::selected_project_statistics() const {
-    ProjectStatistics selected_stats;
+SelectedProjectStatistics TabState::selected_project_statistics() const {
+    SelectedProjectStatistics selected_stats;
 
     for (auto &&s : selected_projects()) {
         assert(stats_.find(s) != stats_.cend());
-        selected_stats.emplace(s, stats_.at(s));
+        selected_stats.emplace(s, &stats_.at(s));
     }
 
     return selected_stats;
@@ -242,36 +244,44 @@ void TabState::update_projects(Projects projects) {
 }
 
 void TabState::update_statistics(Statistics new_stats) {
-    std::set<QString> old_projects;
-    for (auto &&s : stats_)
-        old_projects.insert(s.first);
-
-    stats_.clear();
+    // the statistics are updated in place, so only the new days have to be appended to the charts
+    std::set<QString> new_projects;
+    QStringList added_projects;
 
     for (auto &&ps : new_stats) {
         QString project_url = ps.project.project_url;
         auto piter = std::find_if(projects_.cbegin(), projects_.cend(),
                                   [&](auto &&p) { return p.project_url == project_url; });
-        if (piter != projects_.cend())
+        if (piter == projects_.cend() || !new_projects.insert(piter->name).second)
+            continue;
+
+        auto siter = stats_.find(piter->name);
+        if (siter == stats_.end()) {
             stats_.emplace(piter->name, std::move(ps));
+            added_projects << piter->name;
+        } else {
+            siter->second.project = ps.project;
+            merge_daily_statistics__(siter->second.daily_statistics, std::move(ps.daily_statistics));
+        }
     }
 
-    std::set<QString> new_projects;
-    for (auto &&s : stats_)
-        new_projects.insert(s.first);
-
-    for (auto &&s : old_projects) {
-        if (new_projects.count(s) > 0)
+    for (auto iter = stats_.begin(); iter != stats_.end();) {
+        if (new_projects.count(iter->first) > 0) {
+            ++iter;
             continue;
-        if (selected_project_ == s)
+        }
+
+        const auto project = iter->first;
+        iter = stats_.erase(iter);
+
+        if (selected_project_ == project)
             selected_project_.clear();
-        selected_projects_.removeOne(s);
-        emit project_removed(s);
+        selected_projects_.removeOne(project);
+        emit project_removed(project);
     }
 
-    for (auto &&s : new_projects)
-        if (old_projects.count(s) == 0)
-            emit project_added(s);
+    for (auto &&s : added_projects)
+        emit project_added(s);
 
     emit statistics_updated();
 }
@@ -421,6 +431,135 @@ void CommandsWidget::change_project_list_visibility_(bool visibility) {
     }
 }
 
+// -------- StatisticsChart ---------
+
+StatisticsChart::StatisticsChart() : x_axis_(new QDateTimeAxis), y_axis_(new QValueAxis) {
+    legend()->hide();
+    layout()->setContentsMargins(0, 0, 0, 0);
+
+    x_axis_->setFormat("dd.MMMyy");
+    y_axis_->setLabelFormat("%d");
+
+    addAxis(x_axis_, Qt::AlignBottom);
+    addAxis(y_axis_, Qt::AlignLeft);
+
+    connect(this, &QChart::plotAreaChanged, this, &StatisticsChart::change_plot_area_);
+}
+
+void StatisticsChart::update_series(const std::vector<QVector<QPointF>> &points, const QString &title) {
+    if (this->title() != title)
+        setTitle(title);
+
+    while (series_.size() > points.size()) {
+        auto series = series_.back().series;
+        series_.pop_back();
+        removeSeries(series);
+        delete series;
+    }
+
+    while (series_.size() < points.size()) {
+        auto series = new QLineSeries;
+        series->setPointsVisible();
+
+        addSeries(series);
+        series->attachAxis(x_axis_);
+        series->attachAxis(y_axis_);
+
+        series_.push_back({series, QVector<QPointF>(), false});
+    }
+
+    for (size_t i = 0; i < points.size(); ++i)
+        update_points_(series_[i], points[i]);
+
+    update_axes_();
+}
+
+void StatisticsChart::update_points_(Series &series, const QVector<QPointF> &points) {
+    auto &current = series.points;
+    const int known = current.size();
+
+    auto same_point = [](const QPointF &a, const QPointF &b) { return a.x() == b.x() && a.y() == b.y(); };
+
+    // not an extension of the known points, e.g. the statistics of another project or type;
+    // comparing them is cheap compared to replacing the points of the series
+    if (known == 0 || points.size() < known
+            || !std::equal(current.cbegin(), current.cend() - 1, points.cbegin(), same_point)
+            || points[known - 1].x() != current.back().x()) {
+        current = points;
+        refresh_points_(series);
+        return;
+    }
+
+    // the last known day may have been updated meanwhile
+    const bool last_changed = points[known - 1].y() != current.back().y();
+    if (!last_changed && points.size() == known)
+        return;
+
+    current.back() = points[known - 1];
+    for (int i = known; i < points.size(); ++i)
+        current.append(points[i]);
+
+    if (series.downsampled || (max_points_ > 0 && current.size() > max_points_)) {
+        refresh_points_(series);
+        return;
+    }
+
+    if (last_changed)
+        series.series->replace(known - 1, current[known - 1]);
+    for (int i = known; i < current.size(); ++i)
+        series.series->append(current[i]);
+}
+
+void StatisticsChart::refresh_points_(Series &series) {
+    series.downsampled = max_points_ > 0 && series.points.size() > max_points_;
+    series.series->replace(series.downsampled ? downsample_lttb__(series.points, max_points_) : series.points);
+}
+
+void StatisticsChart::update_axes_() {
+    auto x_range = std::make_pair(std::numeric_limits<qreal>::max(), std::numeric_limits<qreal>::lowest());
+    auto y_range = std::make_pair(std::numeric_limits<qreal>::max(), std::numeric_limits<qreal>::lowest());
+
+    // the ranges of all points, not only of the downsampled ones
+    for (const auto &series : series_) {
+        const auto &points = series.points;
+        if (points.isEmpty())
+            continue;
+
+        x_range.first  = std::min(x_range.first,  points.front().x());
+        x_range.second = std::max(x_range.second, points.back().x());
+
+        auto tmp_y_range = std::minmax_element(points.cbegin(), points.cend(),
+                                               [](const auto &a, const auto &b) { return a.y() < b.y(); });
+
+        y_range.first  = std::min(y_range.first,  tmp_y_range.first->y());
+        y_range.second = std::max(y_range.second, tmp_y_range.second->y());
+    }
+
+    if (x_range.first > x_range.second)
+        return;
+
+    x_axis_->setRange(QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(x_range.first  - MILLISECONDS_PER_DAY)),
+                      QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(x_range.second + MILLISECONDS_PER_DAY)));
+
+    auto gap = std::max((y_range.second - y_range.first) * 0.05, 1.);
+    y_range.first -= gap;
+    y_range.second += gap;
+
+    y_axis_->setRange(std::max(y_range.first, 0.), y_range.second);
+}
+
+void StatisticsChart::change_plot_area_(const QRectF &plot_area) {
+    // one point per pixel
+    const int max_points = plot_area.isEmpty() ? 0 : std::max(static_cast<int>(plot_area.width()), 3);
+    if (max_points == max_points_)
+        return;
+    max_points_ = max_points;
+
+    for (auto &series : series_)
+        if (series.downsampled || (max_points_ > 0 && series.points.size() > max_points_))
+            refresh_points_(series);
+}
+
 // -------- ChartsWidget ---------
 
 ChartsWidget::ChartsWidget(const TabState &state, QWidget *parent)
@@ -479,7 +618,7 @@ void ChartsWidget::update_view_() {
     setUpdatesEnabled(true);
 }
 
-void ChartsWidget::update_header_(const ProjectStatistics &stats) {
+void ChartsWidget::update_header_(const SelectedProjectStatistics &stats) {
     QStringList lines;
     lines << QString("<b>%1</b>").arg(to_string__(state_.statistic_type()));
 
@@ -489,13 +628,13 @@ void ChartsWidget::update_header_(const ProjectStatistics &stats) {
 
         auto last_updated = std::chrono::system_clock::now() -
             (stats.empty() ? std::chrono::system_clock::now() :
-             std::chrono::system_clock::from_time_t(siter->second.daily_statistics.back().day));
+             std::chrono::system_clock::from_time_t(siter->second->daily_statistics.back().day));
         auto last_updated_days = static_cast<int>(std::floor(
                 std::chrono::duration_cast<std::chrono::seconds>(last_updated).count() / SECONDS_PER_DAY));
 
-        lines << QString("<i>Project: %1</i>").arg(stats.empty() ? QString() : siter->second.project.name);
-        lines << QString("<i>Account: %1</i>").arg(stats.empty() ? QString() : siter->second.project.account);
-        lines << QString("<i>Team: %1</i>")   .arg(stats.empty() ? QString() : siter->second.project.team);
+        lines << QString("<i>Project: %1</i>").arg(stats.empty() ? QString() : siter->second->project.name);
+        lines << QString("<i>Account: %1</i>").arg(stats.empty() ? QString() : siter->second->project.account);
+        lines << QString("<i>Team: %1</i>")   .arg(stats.empty() ? QString() : siter->second->project.team);
         lines << QString("<i>Last update: %1 days ago</i>").arg(last_updated_days);
     }
 
@@ -503,7 +642,7 @@ void ChartsWidget::update_header_(const ProjectStatistics &stats) {
     header_->setText(lines.join("<br>"));
 }
 
-void ChartsWidget::update_chart_views_(const ProjectStatistics &stats) {
+void ChartsWidget::update_chart_views_(const SelectedProjectStatistics &stats) {
     assert(charts_->layout());
 
     const int needed = stats.empty() ? 0 :
@@ -526,11 +665,7 @@ void ChartsWidget::update_chart_views_(const ProjectStatistics &stats) {
     int row = 0, column = 0;
 
     while (current++ < needed) {
-        auto chart = new QChart;
-        chart->legend()->hide();
-        chart->layout()->setContentsMargins(0, 0, 0, 0);
-
-        auto chart_view = new QChartView(chart);
+        auto chart_view = new QChartView(new StatisticsChart);
         chart_view->setRenderHint(QPainter::Antialiasing);
         chart_view->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
 
@@ -543,14 +678,14 @@ void ChartsWidget::update_chart_views_(const ProjectStatistics &stats) {
     assert(grid->count() == needed);
 }
 
-void ChartsWidget::update_charts_(const ProjectStatistics &project_statistics) {
+void ChartsWidget::update_charts_(const SelectedProjectStatistics &project_statistics) {
     if (project_statistics.empty())
         return;
 
     std::map<QString, Stats> selected_stats;
 
     for (auto &&ps : project_statistics)
-        selected_stats[ps.first] = to_stats__(ps.second.daily_statistics, stats_selector_);
+        selected_stats[ps.first] = to_stats__(ps.second->daily_statistics, stats_selector_);
 
     if (state_.view_mode() == StatisticViewMode::ALL_PROJECTS_SEPARATE) {
         assert(static_cast<size_t>(charts_->layout()->count()) == selected_stats.size());
@@ -561,7 +696,8 @@ void ChartsWidget::update_charts_(const ProjectStatistics &project_statistics) {
             assert(dynamic_cast<QChartView *>(charts_->layout()->itemAt(item_idx)->widget()));
 
             auto chart_view = static_cast<QChartView *>(charts_->layout()->itemAt(item_idx)->widget());
-            update_chart__(chart_view->chart(), stats.second, stats.first);
+            assert(dynamic_cast<StatisticsChart *>(chart_view->chart()));
+            static_cast<StatisticsChart *>(chart_view->chart())->update_series({stats.second}, stats.first);
 
             item_idx ++;
         }
@@ -570,11 +706,13 @@ void ChartsWidget::update_charts_(const ProjectStatistics &project_statistics) {
         assert(dynamic_cast<QChartView *>(charts_->layout()->itemAt(0)->widget()));
 
         auto chart_view = static_cast<QChartView *>(charts_->layout()->itemAt(0)->widget());
+        assert(dynamic_cast<StatisticsChart *>(chart_view->chart()));
+        auto chart = static_cast<StatisticsChart *>(chart_view->chart());
         auto view_mode = state_.view_mode();
 
         if (view_mode == StatisticViewMode::ONE_PROJECT) {
             assert(selected_stats.size() == 1);
-            update_chart__(chart_view->chart(), selected_stats.cbegin()->second);
+            chart->update_series({selected_stats.cbegin()->second});
         } else {
             std::vector<Stats> stats;
             stats.reserve(selected_stats.size());
@@ -584,9 +722,9 @@ void ChartsWidget::update_charts_(const ProjectStatistics &project_statistics) {
                            [](const auto &it) { return it.second; });
 
             if (view_mode == StatisticViewMode::ALL_PROJECTS_TOGETHER)
-                update_chart__(chart_view->chart(), stats);
+                chart->update_series(stats);
             else
-                update_chart__(chart_view->chart(), sum_stats(stats));
+                chart->update_series({sum_stats(stats)});
         }
     }
 }
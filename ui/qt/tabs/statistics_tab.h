@@ -21,12 +21,19 @@
 
 #include <functional>
 #include <map>
+#include <vector>
 
 #include <QAbstractButton>
 #include <QLabel>
 #include <QListWidget>
+#include <QPointF>
 #include <QStringList>
+#include <QVector>
 #include <QWidget>
+#include <QtCharts/QChart>
+#include <QtCharts/QDateTimeAxis>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QValueAxis>
 
 #include "qt/types.h"
 
@@ -49,6 +56,8 @@ enum class StatisticViewMode {
 // TODO do we really need a map here? If so, let's use the master url as key (better safe than sorry ..);
 // TODO rename this to avoid name clashes
 typedef std::map<QString, woinc::ui::qt::ProjectStatistics> ProjectStatistics;
+// points to the statistics held by the TabState, valid until the next update
+typedef std::map<QString, const woinc::ui::qt::ProjectStatistics *> SelectedProjectStatistics;
 
 typedef decltype(std::mem_fn(&DailyStatistic::user_total_credit)) StatsSelector;
 
@@ -77,7 +86,7 @@ class TabState : public QObject {
         StatisticViewMode view_mode() const;
 
         QStringList selected_projects() const;
-        ProjectStatistics selected_project_statistics() const;
+        SelectedProjectStatistics selected_project_statistics() const;
 
     public slots:
         void update_projects(Projects projects);
@@ -144,6 +153,47 @@ class CommandsWidget : public QWidget {
         bool show_project_list_ = true;
 };
 
+// a chart keeping its series and axes across updates; only new points are appended to a series and
+// a series with more points than the plot area is wide is downsampled
+class StatisticsChart : public QtCharts::QChart {
+    Q_OBJECT
+
+    public:
+        StatisticsChart();
+        virtual ~StatisticsChart() = default;
+
+        StatisticsChart(const StatisticsChart &) = delete;
+        StatisticsChart &operator=(const StatisticsChart &) = delete;
+
+        StatisticsChart(StatisticsChart &&) = delete;
+        StatisticsChart &operator=(StatisticsChart &&) = delete;
+
+        // the points of each series have to be ordered by their x value, the day in ms since epoch
+        void update_series(const std::vector<QVector<QPointF>> &points, const QString &title = QString());
+
+    private:
+        struct Series {
+            QtCharts::QLineSeries *series;
+            // all points, the series itself may only contain a downsampled subset
+            QVector<QPointF> points;
+            bool downsampled;
+        };
+
+        void update_points_(Series &series, const QVector<QPointF> &points);
+        void refresh_points_(Series &series);
+        void update_axes_();
+        void change_plot_area_(const QRectF &plot_area);
+
+    private:
+        std::vector<Series> series_;
+
+        QtCharts::QDateTimeAxis *x_axis_;
+        QtCharts::QValueAxis *y_axis_;
+
+        // the max number of points shown per series, 0 if the plot area isn't known yet
+        int max_points_ = 0;
+};
+
 class ChartsWidget : public QWidget {
     Q_OBJECT
 
@@ -157,9 +207,9 @@ class ChartsWidget : public QWidget {
         void update_view_();
 
     private:
-        void update_header_(const ProjectStatistics &stats);
-        void update_chart_views_(const ProjectStatistics &stats);
-        void update_charts_(const ProjectStatistics &stats);
+        void update_header_(const SelectedProjectStatistics &stats);
+        void update_chart_views_(const SelectedProjectStatistics &stats);
+        void update_charts_(const SelectedProjectStatistics &stats);
 
         void reset_charts_();
 
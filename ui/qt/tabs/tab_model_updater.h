@@ -19,18 +19,87 @@
 #ifndef WOINC_UI_QT_TAB_MODEL_UPDATER_H_
 #define WOINC_UI_QT_TAB_MODEL_UPDATER_H_
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <vector>
 
+#include <QHash>
 #include <QModelIndex>
 
 namespace woinc { namespace ui { namespace qt {
 
-template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename DATA_ITEM_COMP>
+// a bit per column of a tab model, see update_tab_model()
+typedef std::uint64_t ColumnMask;
+
+const ColumnMask ALL_COLUMNS = ~ColumnMask(0);
+
+inline ColumnMask column_mask(int column) {
+    assert(column >= 0 && column < 64);
+    return ColumnMask(1) << column;
+}
+
+namespace tab_model_updater_internals {
+
+// marks the elements of a longest strictly increasing subsequence of the values
+inline std::vector<char> longest_increasing_subsequence(const std::vector<size_t> &values) {
+    // the indices of the smallest tails of the increasing subsequences of length i + 1
+    std::vector<size_t> tails;
+    std::vector<size_t> predecessors(values.size());
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        auto pos = std::lower_bound(tails.begin(), tails.end(), values[i], [&](size_t idx, size_t value) {
+            return values[idx] < value;
+        });
+        if (pos != tails.begin())
+            predecessors[i] = *(pos - 1);
+        if (pos == tails.end())
+            tails.push_back(i);
+        else
+            *pos = i;
+    }
+
+    std::vector<char> result(values.size(), 0);
+    if (!tails.empty()) {
+        size_t idx = tails.back();
+        for (size_t n = tails.size(); n > 0; --n, idx = predecessors[idx])
+            result[idx] = 1;
+    }
+    return result;
+}
+
+template<typename CONTAINER>
+auto at(CONTAINER &container, size_t idx) {
+    return std::next(container.begin(), static_cast<typename CONTAINER::difference_type>(idx));
+}
+
+}
+
+/*
+ * Updates the rows of the tab model to the new data and notifies the views about the changes.
+ *
+ * The rows are matched by the keys returned by key_of, so the containers don't need to be sorted;
+ * sorting is up to the proxy models of the views. Afterwards the rows are in the order of the new data.
+ * The rows not part of the new data are removed, the rows out of order are moved, the new rows are inserted
+ * and the changed rows are updated, each in as few ranges as possible.
+ *
+ * changed_columns(current, new) returns the columns of a row displaying different values, so only
+ * these cells are reported as changed. Adjacent rows with the same changed columns are reported at once.
+ */
+template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename KEY_OF, typename CHANGED_COLUMNS>
 void update_tab_model(TAB_MODEL &model,
                       TARGET_CONTAINER &current_data,
                       SOURCE_CONTAINER new_data,
-                      DATA_ITEM_COMP comp) {
+                      KEY_OF key_of,
+                      CHANGED_COLUMNS changed_columns) {
+    using tab_model_updater_internals::at;
+
+    typedef std::decay_t<decltype(key_of(*new_data.begin()))> Key;
+
     if (new_data.empty()) {
         if (!current_data.empty()) {
             emit model.beginRemoveRows(QModelIndex(), 0, static_cast<int>(current_data.size() - 1));
@@ -40,85 +109,162 @@ void update_tab_model(TAB_MODEL &model,
         return;
     }
 
-    auto current_data_iter = current_data.begin();
-    auto new_data_iter = new_data.begin();
+    // the rows of the new data by their keys
+    QHash<Key, size_t> rows;
+    rows.reserve(static_cast<int>(new_data.size()));
+    for (size_t row = 0; row < new_data.size(); ++row)
+        rows.insert(key_of(*at(new_data, row)), row);
+    assert(static_cast<size_t>(rows.size()) == new_data.size());
+
+    const size_t removed = new_data.size();
 
-    auto do_remove = [&]() {
-        auto end_iter = current_data_iter;
+    // the row of each current item in the new data
+    std::vector<size_t> targets;
+    targets.reserve(current_data.size());
+    for (const auto &item : current_data) {
+        auto row = rows.constFind(key_of(item));
+        targets.push_back(row == rows.cend() ? removed : row.value());
+    }
 
-        while (++end_iter != current_data.end() && comp(*end_iter, *new_data_iter) < 0)
-            ;
+    // remove the rows not part of the new data, starting at the end to not shift the pending ones
+    for (size_t end = targets.size(); end > 0;) {
+        if (targets[end - 1] != removed) {
+            --end;
+            continue;
+        }
 
-        int start_idx = static_cast<int>(std::distance(current_data.begin(), current_data_iter));
-        int end_idx = static_cast<int>(start_idx + std::distance(current_data_iter, end_iter) - 1);
-        assert(end_idx >= start_idx);
-        assert(static_cast<size_t>(end_idx) < current_data.size());
+        size_t begin = end - 1;
+        while (begin > 0 && targets[begin - 1] == removed)
+            --begin;
 
-        emit model.beginRemoveRows(QModelIndex(), start_idx, end_idx);
-        current_data_iter = current_data.erase(current_data_iter, end_iter);
+        emit model.beginRemoveRows(QModelIndex(), static_cast<int>(begin), static_cast<int>(end - 1));
+        current_data.erase(at(current_data, begin), at(current_data, end));
+        targets.erase(at(targets, begin), at(targets, end));
         emit model.endRemoveRows();
-    };
 
-    auto do_update = [&]() {
-        if (*current_data_iter != *new_data_iter) {
-            *current_data_iter = *new_data_iter;
-            int row_idx = static_cast<int>(std::distance(current_data.begin(), current_data_iter));
-            emit model.dataChanged(model.createIndex(row_idx, 0),
-                                   model.createIndex(row_idx, model.columnCount() - 1));
-        }
-        current_data_iter ++;
-        new_data_iter ++;
-    };
+        end = begin;
+    }
 
-    auto do_insert = [&]() {
-        int row_idx = static_cast<int>(std::distance(current_data.begin(), current_data_iter));
-        emit model.beginInsertRows(QModelIndex(), row_idx, row_idx);
-        current_data_iter = current_data.insert(current_data_iter, std::move(*new_data_iter));
-        emit model.endInsertRows();
-        current_data_iter ++;
-        new_data_iter ++;
-    };
+    // move the rows out of order, keeping the rows of a longest increasing subsequence in place
+    auto placed = tab_model_updater_internals::longest_increasing_subsequence(targets);
 
-    // adapt changes from the new data set to the current data set
-    while (current_data_iter != current_data.end() && new_data_iter != new_data.end()) {
-        int result = comp(*current_data_iter, *new_data_iter);
-        if (result < 0) {
-            do_remove();
-        } else if (result == 0) {
-            do_update();
-        } else {
-            do_insert();
+    std::vector<size_t> pending;
+    for (size_t row = 0; row < targets.size(); ++row)
+        if (!placed[row])
+            pending.push_back(targets[row]);
+    std::sort(pending.begin(), pending.end());
+
+    for (size_t next = 0; next < pending.size();) {
+        const size_t target = pending[next];
+        const size_t src = static_cast<size_t>(std::distance(targets.begin(),
+                                                             std::find(targets.begin(), targets.end(), target)));
+
+        // rows adjacent in the current and in the new data are moved at once
+        size_t count = 1;
+        while (next + count < pending.size()
+               && pending[next + count] == target + count
+               && src + count < targets.size()
+               && targets[src + count] == target + count)
+            ++count;
+
+        // move them right before the first placed row following them in the new data
+        size_t dest = 0;
+        while (dest < targets.size() && !(placed[dest] && targets[dest] > target))
+            ++dest;
+
+        if (dest != src + count) {
+            assert(dest < src || dest > src + count);
+            emit model.beginMoveRows(QModelIndex(), static_cast<int>(src), static_cast<int>(src + count - 1),
+                                     QModelIndex(), static_cast<int>(dest));
+
+            auto rotate = [&](auto &container) {
+                if (dest < src)
+                    std::rotate(at(container, dest), at(container, src), at(container, src + count));
+                else
+                    std::rotate(at(container, src), at(container, src + count), at(container, dest));
+            };
+            rotate(current_data);
+            rotate(targets);
+            rotate(placed);
+
+            emit model.endMoveRows();
         }
-    }
 
-    // if we reached the end of new data before the end of current data, remove all remaining items
-    if (current_data_iter != current_data.end()) {
-        int start_idx = static_cast<int>(std::distance(current_data.begin(), current_data_iter));
-        int end_idx = static_cast<int>(current_data.size() - 1);
-        assert(end_idx >= start_idx);
+        const size_t moved = dest < src ? dest : dest - count;
+        std::fill(at(placed, moved), at(placed, moved + count), 1);
 
-        model.beginRemoveRows(QModelIndex(), start_idx, end_idx);
-        current_data_iter = current_data.erase(current_data_iter, current_data.end());
-        model.endRemoveRows();
+        next += count;
     }
 
-    assert(current_data_iter == current_data.end());
+    assert(std::is_sorted(targets.begin(), targets.end()));
+
+    // insert the new rows and update the existing ones, the rows before row are in sync with the new data
+    const int column_count = model.columnCount();
+    const ColumnMask columns = column_count < 64 ? column_mask(column_count) - 1 : ALL_COLUMNS;
+
+    size_t changed = removed;
+    ColumnMask changed_mask = 0;
+
+    auto flush_changed = [&](size_t end) {
+        if (changed == removed)
+            return;
+
+        // a range per run of changed columns
+        for (int first = 0; first < column_count; ++first) {
+            if (!(changed_mask & column_mask(first)))
+                continue;
 
-    // append all remaining new items to the data set
-    if (new_data_iter != new_data.end()) {
-        assert(current_data.size() < new_data.size());
-        emit model.beginInsertRows(QModelIndex(),
-                                   static_cast<int>(current_data.size()),
-                                   static_cast<int>(new_data.size() - 1));
+            int last = first;
+            while (last + 1 < column_count && (changed_mask & column_mask(last + 1)))
+                ++last;
 
-        while (new_data_iter != new_data.end()) {
-            current_data.push_back(std::move(*new_data_iter));
-            new_data_iter ++;
+            emit model.dataChanged(model.createIndex(static_cast<int>(changed), first),
+                                   model.createIndex(static_cast<int>(end - 1), last));
+            first = last;
         }
 
-        emit model.endInsertRows();
+        changed = removed;
+        changed_mask = 0;
+    };
+
+    for (size_t row = 0; row < new_data.size();) {
+        if (row < targets.size() && targets[row] == row) {
+            auto current = at(current_data, row);
+            auto item = at(new_data, row);
+
+            const ColumnMask mask = changed_columns(*current, *item) & columns;
+
+            if (mask != changed_mask)
+                flush_changed(row);
+            if (mask && changed == removed) {
+                changed = row;
+                changed_mask = mask;
+            }
+
+            // the data not displayed may have changed too
+            *current = std::move(*item);
+
+            ++row;
+        } else {
+            flush_changed(row);
+
+            // the new rows up to the next current one
+            size_t end = row < targets.size() ? targets[row] : new_data.size();
+
+            emit model.beginInsertRows(QModelIndex(), static_cast<int>(row), static_cast<int>(end - 1));
+            current_data.insert(at(current_data, row),
+                                std::make_move_iterator(at(new_data, row)),
+                                std::make_move_iterator(at(new_data, end)));
+            targets.insert(at(targets, row), end - row, 0);
+            std::iota(at(targets, row), at(targets, end), row);
+            emit model.endInsertRows();
+
+            row = end;
+        }
     }
 
+    flush_changed(new_data.size());
+
     assert(current_data.size() == new_data.size());
 }
 
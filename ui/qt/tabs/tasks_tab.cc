@@ -31,10 +31,13 @@
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QMessageBox>
+#include <QPair>
 #include <QPushButton>
 #include <QScrollArea>
 #include <QTextStream>
 
+#include <woinc/trace.h>
+
 #include "qt/dialogs/task_properties_dialog.h"
 #include "qt/tabs/delegates.h"
 #include "qt/tabs/proxy_models.h"
@@ -58,15 +61,19 @@ enum {
     COLUMN_COUNT = 8
 };
 
-int compare(const QString &a, const QString &b) {
-    return a.localeAwareCompare(b);
-}
-
-int compare(const woinc::ui::qt::Task &a, const woinc::ui::qt::Task &b) {
-    int result = compare(a.project, b.project);
-    if (!result)
-        result = compare(a.task_name, b.task_name);
-    return result;
+woinc::ui::qt::ColumnMask changed_columns(const woinc::ui::qt::Task &a, const woinc::ui::qt::Task &b) {
+    using woinc::ui::qt::column_mask;
+
+    woinc::ui::qt::ColumnMask mask = 0;
+    if (a.project != b.project)         mask |= column_mask(INDEX_PROJECT);
+    if (a.progress != b.progress)       mask |= column_mask(INDEX_PROGRESS);
+    if (a.status != b.status)           mask |= column_mask(INDEX_STATUS);
+    if (a.elapsed != b.elapsed)         mask |= column_mask(INDEX_ELAPSED);
+    if (a.remaining != b.remaining)     mask |= column_mask(INDEX_REMAINING);
+    if (a.deadline != b.deadline)       mask |= column_mask(INDEX_DEADLINE);
+    if (a.application != b.application) mask |= column_mask(INDEX_APPLICATION);
+    if (a.task_name != b.task_name)     mask |= column_mask(INDEX_TASK_NAME);
+    return mask;
 }
 
 } // unnamed namespace
@@ -106,10 +113,7 @@ ButtonPanel::ButtonPanel(QWidget *parent) : QWidget(parent) {
 #undef WOINC_CONNECT_BTN
 
 #define WOINC_CONNECT_BTN(BTN, OP) connect(cmd_btns_[BTN], &QPushButton::released, this, \
-                                           [&]() { \
-                                               for (auto &&task : selected_tasks_) \
-                                                   emit task_op_clicked(task.host, task.project_url, task.task_name, OP); \
-                                           })
+                                           [&]() { emit task_op_clicked(selected_tasks_, OP); })
 
     WOINC_CONNECT_BTN(Command::SUSPEND, TASK_OP::SUSPEND);
     WOINC_CONNECT_BTN(Command::RESUME, TASK_OP::RESUME);
@@ -131,8 +135,7 @@ ButtonPanel::ButtonPanel(QWidget *parent) : QWidget(parent) {
 
                 if (QMessageBox::question(this, QString::fromUtf8("Abort task"), msg,
                                           QMessageBox::No | QMessageBox::Yes) == QMessageBox::Yes)
-                    for (auto &&task : selected_tasks_)
-                        emit task_op_clicked(task.host, task.project_url, task.task_name, TASK_OP::ABORT);
+                    emit task_op_clicked(selected_tasks_, TASK_OP::ABORT);
             });
 
     connect(cmd_btns_[Command::PROPERTIES], &QPushButton::released, this,
@@ -308,10 +311,12 @@ void TabModel::select_tasks(SelectedRows selected_rows) {
 }
 
 void TabModel::update_tasks(Tasks new_tasks) {
+    WOINC_TRACE_SPAN("qt.update_tab_model");
     update_tab_model(*this,
                      tasks_,
                      std::move(new_tasks),
-                     [](const Task &a, const Task &b) { return compare(a,b); });
+                     [](const Task &task) { return qMakePair(task.project_url, task.task_name); },
+                     &changed_columns);
 
     emit tasks_updated();
 }
@@ -37,11 +37,12 @@
 namespace woinc { namespace ui { namespace qt {
 
 // forward declaration for usage as friend later on
-template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename DATA_ITEM_COMP>
+template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename KEY_OF, typename CHANGED_COLUMNS>
 void update_tab_model(TAB_MODEL &model,
                       TARGET_CONTAINER &current_data,
                       SOURCE_CONTAINER new_data,
-                      DATA_ITEM_COMP comp);
+                      KEY_OF key_of,
+                      CHANGED_COLUMNS changed_columns);
 
 namespace tasks_tab_internals {
 
@@ -63,7 +64,7 @@ class ButtonPanel : public QWidget {
 
     signals:
         void active_only_tasks_clicked(QString host, bool value);
-        void task_op_clicked(QString host, QString project_url, QString name, TASK_OP op);
+        void task_op_clicked(Tasks tasks, TASK_OP op);
 
     private:
         enum class Command {
@@ -101,11 +102,12 @@ class TabModel : public QAbstractTableModel {
         QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
     public:
-        template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename DATA_ITEM_COMP>
+        template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename KEY_OF, typename CHANGED_COLUMNS>
         friend void woinc::ui::qt::update_tab_model(TAB_MODEL &model,
                                                     TARGET_CONTAINER &current_data,
                                                     SOURCE_CONTAINER new_data,
-                                                    DATA_ITEM_COMP comp);
+                                                    KEY_OF key_of,
+                                                    CHANGED_COLUMNS changed_columns);
 
     public slots:
         void select_host(QString host);
@@ -155,7 +157,7 @@ class TasksTab : public QWidget {
 
     signals:
         void active_only_tasks_clicked(QString host, bool value);
-        void task_op_clicked(QString host, QString project_url, QString name, TASK_OP op);
+        void task_op_clicked(Tasks tasks, TASK_OP op);
 
         // delegated signals from the model to the internal widgets
 
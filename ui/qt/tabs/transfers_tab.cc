@@ -24,11 +24,14 @@
 #include <QHBoxLayout>
 #include <QHeaderView>
 #include <QMessageBox>
+#include <QPair>
 #include <QPushButton>
 #include <QScrollArea>
 #include <QTextStream>
 #include <QVBoxLayout>
 
+#include <woinc/trace.h>
+
 #include "qt/utils.h"
 #include "qt/tabs/delegates.h"
 #include "qt/tabs/proxy_models.h"
@@ -50,16 +53,24 @@ enum {
     COLUMN_COUNT = 7,
 };
 
-int compare(const QString &a, const QString &b) {
-    return a.localeAwareCompare(b);
-}
-
-int compare(const woinc::ui::qt::FileTransfer &a,
-            const woinc::ui::qt::FileTransfer &b) {
-    int result = compare(a.project, b.project);
-    if (!result)
-        result = compare(a.file, b.file);
-    return result;
+woinc::ui::qt::ColumnMask changed_columns(const woinc::ui::qt::FileTransfer &a,
+                                          const woinc::ui::qt::FileTransfer &b) {
+    using woinc::ui::qt::column_mask;
+
+    woinc::ui::qt::ColumnMask mask = 0;
+    if (a.project != b.project)
+        mask |= column_mask(INDEX_PROJECT);
+    if (a.file != b.file)
+        mask |= column_mask(INDEX_FILE);
+    if (a.size != b.size || a.bytes_xferred != b.bytes_xferred)
+        mask |= column_mask(INDEX_PROGRESS) | column_mask(INDEX_SIZE);
+    if (a.elapsed != b.elapsed)
+        mask |= column_mask(INDEX_ELAPSED);
+    if (a.speed != b.speed)
+        mask |= column_mask(INDEX_SPEED);
+    if (a.status != b.status)
+        mask |= column_mask(INDEX_STATUS);
+    return mask;
 }
 
 QString size_to_string(double file_size, double bytes_send) {
@@ -247,10 +258,12 @@ SelectedTransfer TabModel::selected_transfer(size_t row) const {
 }
 
 void TabModel::update(FileTransfers file_transfers) {
+    WOINC_TRACE_SPAN("qt.update_tab_model");
     update_tab_model(*this,
                      file_transfers_,
                      std::move(file_transfers),
-                     [](const FileTransfer &a, const FileTransfer &b) { return compare(a,b); });
+                     [](const FileTransfer &transfer) { return qMakePair(transfer.project_url, transfer.file); },
+                     &changed_columns);
 }
 
 // ------- TableView -------
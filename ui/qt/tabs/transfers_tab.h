@@ -34,11 +34,12 @@
 namespace woinc { namespace ui { namespace qt {
 
 // forward declaration for usage as friend later on
-template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename DATA_ITEM_COMP>
+template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename KEY_OF, typename CHANGED_COLUMNS>
 void update_tab_model(TAB_MODEL &model,
                       TARGET_CONTAINER &current_data,
                       SOURCE_CONTAINER new_data,
-                      DATA_ITEM_COMP comp);
+                      KEY_OF key_of,
+                      CHANGED_COLUMNS changed_columns);
 
 namespace transfers_tab_internals {
 
@@ -106,11 +107,12 @@ class TabModel : public QAbstractTableModel {
         QVariant headerData(int section, Qt::Orientation orientation, int role) const final;
 
     public:
-        template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename DATA_ITEM_COMP>
+        template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename KEY_OF, typename CHANGED_COLUMNS>
         friend void woinc::ui::qt::update_tab_model(TAB_MODEL &model,
                                                     TARGET_CONTAINER &current_data,
                                                     SOURCE_CONTAINER new_data,
-                                                    DATA_ITEM_COMP comp);
+                                                    KEY_OF key_of,
+                                                    CHANGED_COLUMNS changed_columns);
 
         SelectedTransfer selected_transfer(size_t row) const;
 
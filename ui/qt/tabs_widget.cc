@@ -37,8 +37,6 @@ TabsWidget::TabsWidget(const Model &model, Controller &controller, QWidget *pare
         auto *tab = new NoticesTab(this);
         tab_indices_.emplace(TAB::NOTICES, addTab(tab, "Notices"));
 
-        connect(&model, &Model::host_selected,     tab, &NoticesTab::select_host);
-        connect(&model, &Model::host_unselected,   tab, &NoticesTab::unselect_host);
         connect(&model, &Model::notices_appended,  tab, &NoticesTab::append_notices);
         connect(&model, &Model::notices_refreshed, tab, &NoticesTab::refresh_notices);
     }
@@ -99,9 +97,8 @@ TabsWidget::TabsWidget(const Model &model, Controller &controller, QWidget *pare
         auto *tab = new EventsTab(this);
         tab_indices_.emplace(TAB::EVENTS, addTab(tab, "Events"));
 
-        connect(&model, &Model::events_appended, tab, &EventsTab::events_appended);
-        connect(&model, &Model::host_selected,   tab, &EventsTab::host_selected);
-        connect(&model, &Model::host_unselected, tab, &EventsTab::host_unselected);
+        connect(&model, &Model::events_selected, tab, &EventsTab::select_events);
+        connect(&model, &Model::events_appended, tab, &EventsTab::append_events);
     }
 }
 
@@ -0,0 +1,280 @@
+/* ui/qt/task_status.cc --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#include "qt/task_status.h"
+
+#include "common/types_to_string.h"
+
+namespace {
+
+// the statuses depend on a few strings like the resources, but to be safe the cache is bounded
+const size_t MAX_CACHED_STATUSES = 1024;
+
+bool uses_gpu(const woinc::Task &task) {
+    // TODO is there another way to determine this?
+    return task.resources.find("GPU") != task.resources.npos;
+}
+
+QString suspend_reason_to_string(int reason) {
+    return QString::fromUtf8(woinc::ui::common::to_string(static_cast<woinc::SUSPEND_REASON>(reason)));
+}
+
+}
+
+namespace woinc { namespace ui { namespace qt {
+
+QString TaskStatusResolver::resolve(const woinc::Task &task, const woinc::CCStatus &cc_status, bool non_cpu_intensive) {
+    if (statuses_.size() >= MAX_CACHED_STATUSES) {
+        statuses_.clear();
+        string_ids_.clear();
+        strings_.clear();
+    }
+
+    const auto key = key_(task, cc_status, non_cpu_intensive);
+
+    auto iter = statuses_.find(key);
+    if (iter == statuses_.end())
+        iter = statuses_.emplace(key, format_(key)).first;
+
+    return iter->second;
+}
+
+TaskStatusResolver::Key TaskStatusResolver::key_(const woinc::Task &task,
+                                                 const woinc::CCStatus &cc_status,
+                                                 bool non_cpu_intensive) {
+    Status status = Status::NONE;
+    int detail = 0;
+    int wait_reason = -1;
+    // some statuses replace the "GPU missing" prefix
+    bool gpu_missing = task.coproc_missing;
+
+    switch (task.state) {
+        case woinc::RESULT_CLIENT_STATE::NEW:
+            status = Status::NEW;
+            break;
+        case woinc::RESULT_CLIENT_STATE::FILES_DOWNLOADING:
+            if (task.ready_to_report) {
+                status = Status::DOWNLOAD_FAILED;
+            } else if (cc_status.network.suspend_reason != woinc::SUSPEND_REASON::NOT_SUSPENDED) {
+                status = Status::DOWNLOADING_SUSPENDED;
+                detail = static_cast<int>(cc_status.network.suspend_reason);
+            } else {
+                status = Status::DOWNLOADING;
+            }
+            break;
+        case woinc::RESULT_CLIENT_STATE::FILES_DOWNLOADED:
+            status = files_downloaded_status_(task, cc_status, non_cpu_intensive);
+            if (status == Status::SUSPENDED)
+                detail = static_cast<int>(cc_status.cpu.suspend_reason);
+            else if (status == Status::GPU_SUSPENDED)
+                detail = static_cast<int>(cc_status.gpu.suspend_reason);
+            // TODO: this is what BOINC does, but I'm not yet sure, if it's the right thing to do here ..
+            // why delete the maybe existing 'GPU missing' string?
+            if (task.scheduler_wait) {
+                status = Status::POSTPONED;
+                detail = 0;
+                wait_reason = intern_(task.scheduler_wait_reason);
+                gpu_missing = false;
+            }
+            if (task.network_wait) {
+                status = Status::WAITING_FOR_NETWORK;
+                detail = 0;
+                wait_reason = -1;
+                gpu_missing = false;
+            }
+            break;
+        case woinc::RESULT_CLIENT_STATE::COMPUTE_ERROR:
+            status = Status::COMPUTE_ERROR;
+            break;
+        case woinc::RESULT_CLIENT_STATE::FILES_UPLOADING:
+            if (task.ready_to_report) {
+                status = Status::UPLOAD_FAILED;
+            } else if (cc_status.network.suspend_reason != woinc::SUSPEND_REASON::NOT_SUSPENDED) {
+                status = Status::UPLOADING_SUSPENDED;
+                detail = static_cast<int>(cc_status.network.suspend_reason);
+            } else {
+                status = Status::UPLOADING;
+            }
+            break;
+        case woinc::RESULT_CLIENT_STATE::ABORTED:
+            status = Status::ABORTED;
+            detail = task.exit_status;
+            break;
+        default:
+            if (task.got_server_ack) {
+                status = Status::ACKNOWLEDGED;
+            } else if (task.ready_to_report) {
+                status = Status::READY_TO_REPORT;
+            } else {
+                status = Status::INVALID_STATE;
+                detail = static_cast<int>(task.state);
+                gpu_missing = false;
+            }
+    }
+
+    return Key(status, gpu_missing, detail, wait_reason, intern_(task.resources));
+}
+
+TaskStatusResolver::Status TaskStatusResolver::files_downloaded_status_(const woinc::Task &task,
+                                                                        const woinc::CCStatus &cc_status,
+                                                                        bool non_cpu_intensive) const {
+    bool throttled = cc_status.cpu.suspend_reason == woinc::SUSPEND_REASON::CPU_THROTTLE;
+
+    if (task.project_suspended_via_gui)
+        return Status::PROJECT_SUSPENDED;
+    if (task.suspended_via_gui)
+        return Status::TASK_SUSPENDED;
+    if (cc_status.cpu.suspend_reason != woinc::SUSPEND_REASON::NOT_SUSPENDED
+            && !throttled
+            && task.active_task != nullptr
+            && task.active_task->active_task_state != woinc::ACTIVE_TASK_STATE::EXECUTING)
+        return Status::SUSPENDED;
+    if (cc_status.gpu.suspend_reason != woinc::SUSPEND_REASON::NOT_SUSPENDED && uses_gpu(task))
+        return Status::GPU_SUSPENDED;
+    if (task.active_task == nullptr)
+        return Status::READY_TO_START;
+    if (task.active_task->too_large)
+        return Status::WAITING_FOR_MEMORY;
+    if (task.active_task->needs_shmem)
+        return Status::WAITING_FOR_SHARED_MEMORY;
+
+    switch (task.active_task->scheduler_state) {
+        case woinc::SCHEDULER_STATE::SCHEDULED:
+            return non_cpu_intensive ? Status::RUNNING_NON_CPU_INTENSIVE : Status::RUNNING;
+        case woinc::SCHEDULER_STATE::PREEMPTED:
+            return Status::WAITING_TO_RUN;
+        case woinc::SCHEDULER_STATE::UNINITIALIZED:
+            return Status::READY_TO_START;
+        case woinc::SCHEDULER_STATE::UNKNOWN_TO_WOINC:
+            break;
+    }
+
+    return Status::NONE;
+}
+
+QString TaskStatusResolver::format_(const Key &key) const {
+    Status status;
+    bool gpu_missing;
+    int detail, wait_reason, resources;
+    std::tie(status, gpu_missing, detail, wait_reason, resources) = key;
+
+    QString result;
+
+    if (gpu_missing)
+        result += QString::fromUtf8("GPU missing, ");
+
+    switch (status) {
+        case Status::NONE:
+            break;
+        case Status::NEW:
+            result += QString::fromUtf8("New");
+            break;
+        case Status::DOWNLOAD_FAILED:
+            result += QString::fromUtf8("Download failed");
+            break;
+        case Status::DOWNLOADING:
+            result += QString::fromUtf8("Downloading");
+            break;
+        case Status::DOWNLOADING_SUSPENDED:
+            result += QString::fromUtf8("Downloading (suspended - ") + suspend_reason_to_string(detail) + ")";
+            break;
+        case Status::PROJECT_SUSPENDED:
+            result += QString::fromUtf8("Project suspended by user");
+            break;
+        case Status::TASK_SUSPENDED:
+            result += QString::fromUtf8("Task suspended by user");
+            break;
+        case Status::SUSPENDED:
+            result += QString::fromUtf8("Suspended - ") + suspend_reason_to_string(detail);
+            break;
+        case Status::GPU_SUSPENDED:
+            result += QString::fromUtf8("GPU suspended - ") + suspend_reason_to_string(detail);
+            break;
+        case Status::WAITING_FOR_MEMORY:
+            result += QString::fromUtf8("Waiting for memory");
+            break;
+        case Status::WAITING_FOR_SHARED_MEMORY:
+            result += QString::fromUtf8("Waiting for shared memory");
+            break;
+        case Status::RUNNING:
+            result += QString::fromUtf8("Running");
+            break;
+        case Status::RUNNING_NON_CPU_INTENSIVE:
+            result += QString::fromUtf8("Running (non-CPU-intensive)");
+            break;
+        case Status::WAITING_TO_RUN:
+            result += QString::fromUtf8("Waiting to run");
+            break;
+        case Status::READY_TO_START:
+            result += QString::fromUtf8("Ready to start");
+            break;
+        case Status::POSTPONED:
+            result += QString::fromUtf8("Postponed");
+            if (wait_reason >= 0)
+                result += QString::fromUtf8(": ") + strings_[static_cast<size_t>(wait_reason)];
+            break;
+        case Status::WAITING_FOR_NETWORK:
+            result += QString::fromUtf8("Waiting for network access");
+            break;
+        case Status::COMPUTE_ERROR:
+            result += QString::fromUtf8("Computation error");
+            break;
+        case Status::UPLOAD_FAILED:
+            result += QString::fromUtf8("Upload failed");
+            break;
+        case Status::UPLOADING:
+            result += QString::fromUtf8("Uploading");
+            break;
+        case Status::UPLOADING_SUSPENDED:
+            result += QString::fromUtf8("Uploading (suspended - ") + suspend_reason_to_string(detail) + ")";
+            break;
+        case Status::ABORTED:
+            result += QString::fromUtf8(woinc::ui::common::exit_code_to_string(detail));
+            break;
+        case Status::ACKNOWLEDGED:
+            result += QString::fromUtf8("Acknowledged");
+            break;
+        case Status::READY_TO_REPORT:
+            result += QString::fromUtf8("Ready to report");
+            break;
+        case Status::INVALID_STATE:
+            result += QString::fromUtf8("Error: invalid state '") + QString::number(detail) + "'";
+            break;
+    }
+
+    if (resources >= 0)
+        result += QString::fromUtf8(" (") + strings_[static_cast<size_t>(resources)] + ")";
+
+    return result;
+}
+
+int TaskStatusResolver::intern_(const std::string &str) {
+    if (str.empty())
+        return -1;
+
+    auto iter = string_ids_.find(str);
+    if (iter == string_ids_.end()) {
+        iter = string_ids_.emplace(str, static_cast<int>(strings_.size())).first;
+        strings_.push_back(QString::fromStdString(str));
+    }
+
+    return iter->second;
+}
+
+}}}
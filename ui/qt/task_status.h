@@ -0,0 +1,95 @@
+/* ui/qt/task_status.h --
+   Written and Copyright (C) 2019 by vmc.
+
+   This file is part of woinc.
+
+   woinc is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   woinc is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with woinc. If not, see <http://www.gnu.org/licenses/>. */
+
+
+#ifndef WOINC_UI_QT_TASK_STATUS_H_
+#define WOINC_UI_QT_TASK_STATUS_H_
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <QString>
+
+#include <woinc/types.h>
+
+namespace woinc { namespace ui { namespace qt {
+
+/*
+ * Resolves the status of a task, see BOINC's clientgui/MainDocument.cpp result_description().
+ *
+ * There are only a few distinct statuses, so a task is mapped to a key of enums and ids first and
+ * the string of each key is formatted once. All tasks with the same status share that string.
+ *
+ * The resolver is not threadsafe, it's supposed to be used by the ModelHandler only.
+ */
+class TaskStatusResolver {
+    public:
+        QString resolve(const woinc::Task &task, const woinc::CCStatus &cc_status, bool non_cpu_intensive);
+
+    private:
+        enum class Status {
+            NONE,
+            NEW,
+            DOWNLOAD_FAILED,
+            DOWNLOADING,
+            DOWNLOADING_SUSPENDED,
+            PROJECT_SUSPENDED,
+            TASK_SUSPENDED,
+            SUSPENDED,
+            GPU_SUSPENDED,
+            WAITING_FOR_MEMORY,
+            WAITING_FOR_SHARED_MEMORY,
+            RUNNING,
+            RUNNING_NON_CPU_INTENSIVE,
+            WAITING_TO_RUN,
+            READY_TO_START,
+            POSTPONED,
+            WAITING_FOR_NETWORK,
+            COMPUTE_ERROR,
+            UPLOAD_FAILED,
+            UPLOADING,
+            UPLOADING_SUSPENDED,
+            ABORTED,
+            ACKNOWLEDGED,
+            READY_TO_REPORT,
+            INVALID_STATE
+        };
+
+        // (status, GPU missing, suspend reason/exit status/state depending on the status,
+        //  id of the scheduler wait reason, id of the resources), an id is -1 if there's no string
+        typedef std::tuple<Status, bool, int, int, int> Key;
+
+        Key key_(const woinc::Task &task, const woinc::CCStatus &cc_status, bool non_cpu_intensive);
+        Status files_downloaded_status_(const woinc::Task &task, const woinc::CCStatus &cc_status,
+                                        bool non_cpu_intensive) const;
+        QString format_(const Key &key) const;
+
+        int intern_(const std::string &str);
+
+    private:
+        std::map<Key, QString> statuses_;
+
+        std::map<std::string, int> string_ids_;
+        std::vector<QString> strings_;
+};
+
+}}}
+
+#endif
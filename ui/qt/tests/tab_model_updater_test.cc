@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <vector>
@@ -6,7 +7,7 @@
 #include <QTableView>
 #include <QtTest>
 
-#include "../widgets/tab_model_updater.h"
+#include "../tabs/tab_model_updater.h"
 
 namespace {
 
@@ -14,10 +15,14 @@ struct Data {
     QString a, b;
 };
 
-// compare 'a' only to be able to trigger updates on data
-int compare(const Data &d1, const Data &d2) {
-    int result = d1.a.compare(d2.a);
-    return result;
+// key by 'a' only to be able to trigger updates on data
+QString key(const Data &d) {
+    return d.a;
+}
+
+woinc::ui::qt::ColumnMask changed_columns(const Data &d1, const Data &d2) {
+    return (d1.a != d2.a ? woinc::ui::qt::column_mask(0) : 0)
+        | (d1.b != d2.b ? woinc::ui::qt::column_mask(1) : 0);
 }
 
 bool operator==(const Data &d1, const Data &d2) {
@@ -36,6 +41,11 @@ class TabView : public QObject {
             connect(&model, &QAbstractTableModel::dataChanged, this, &TabView::onDataChanged);
             connect(&model, &QAbstractTableModel::rowsInserted, this, &TabView::onRowsInserted);
             connect(&model, &QAbstractTableModel::rowsRemoved, this, &TabView::onRowsRemoved);
+            connect(&model, &QAbstractTableModel::rowsMoved, this, &TabView::onRowsMoved);
+        }
+
+        int num_changes() const {
+            return num_changes_;
         }
 
         const std::vector<Data> &data() const {
@@ -44,6 +54,7 @@ class TabView : public QObject {
 
     public slots:
         void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &) {
+            ++num_changes_;
             for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
                 for (int col = topLeft.column(); col <= bottomRight.column(); ++col) {
                     QVERIFY(col == 0 || col == 1);
@@ -54,6 +65,7 @@ class TabView : public QObject {
         }
 
         void onRowsInserted(const QModelIndex &/*parent*/, int first, int last) {
+            ++num_changes_;
             auto insert_iter = data_.begin() + first;
 
             for (;first <= last; ++first, ++insert_iter) {
@@ -65,12 +77,22 @@ class TabView : public QObject {
         }
 
         void onRowsRemoved(const QModelIndex &/*parent*/, int first, int last) {
+            ++num_changes_;
             data_.erase(data_.begin() + first, data_.begin() + last + 1);
         }
 
+        void onRowsMoved(const QModelIndex &/*parent*/, int first, int last, const QModelIndex &/*destination*/, int row) {
+            ++num_changes_;
+            if (row < first)
+                std::rotate(data_.begin() + row, data_.begin() + first, data_.begin() + last + 1);
+            else
+                std::rotate(data_.begin() + first, data_.begin() + last + 1, data_.begin() + row);
+        }
+
     private:
-        QAbstractTableModel &model_;
+        const QAbstractTableModel &model_;
         std::vector<Data> data_;
+        int num_changes_ = 0;
 };
 
 class TabModel : public QAbstractTableModel {
@@ -79,11 +101,12 @@ class TabModel : public QAbstractTableModel {
     public:
         virtual ~TabModel() = default;
 
-        template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename DATA_ITEM_COMP>
+        template<typename TAB_MODEL, typename TARGET_CONTAINER, typename SOURCE_CONTAINER, typename KEY_OF, typename CHANGED_COLUMNS>
         friend void woinc::ui::qt::update_tab_model(TAB_MODEL &model,
                                                     TARGET_CONTAINER &current_data,
                                                     SOURCE_CONTAINER new_data,
-                                                    DATA_ITEM_COMP comp);
+                                                    KEY_OF key_of,
+                                                    CHANGED_COLUMNS changed_columns);
 
         int rowCount(const QModelIndex &parent = QModelIndex()) const final override {
             return parent.isValid() ? 0 : static_cast<int>(data_.size());
@@ -105,7 +128,7 @@ class TabModel : public QAbstractTableModel {
         }
 
         void update(std::vector<Data> new_data) {
-            woinc::ui::qt::update_tab_model(*this, data_, std::move(new_data), &compare);
+            woinc::ui::qt::update_tab_model(*this, data_, std::move(new_data), &key, &changed_columns);
         }
 
         const std::vector<Data> &data() const {
@@ -163,6 +186,15 @@ class TestTabModelUpdater : public QObject {
         void remove_all();
 
         void mixed();
+
+        void move_single();
+        void move_multiple();
+        void reorder();
+
+        void merge_updates();
+
+        void benchmark_unchanged();
+        void benchmark_mixed();
 };
 
 void TestTabModelUpdater::insert_empty_single() {
@@ -488,5 +520,132 @@ void TestTabModelUpdater::mixed() {
     assert_equals(model.data(), view.data());
 }
 
+void TestTabModelUpdater::move_single() {
+    TabModel model;
+    TabView view(model);
+
+    const Data data1 = { "A", "B" };
+    const Data data2 = { "C", "D" };
+    const Data data3 = { "E", "F" };
+    const Data data4 = { "G", "H" };
+
+    model.update({data1, data2, data3, data4});
+    const int changes = view.num_changes();
+    model.update({data2, data3, data4, data1});
+
+    QCOMPARE(view.num_changes() - changes, 1);
+    assert_row_count(view, 4);
+    assert_content(view, 0, data2);
+    assert_content(view, 3, data1);
+    assert_equals(model.data(), view.data());
+}
+
+void TestTabModelUpdater::move_multiple() {
+    TabModel model;
+    TabView view(model);
+
+    const Data data1 = { "A", "B" };
+    const Data data2 = { "C", "D" };
+    const Data data3 = { "E", "F" };
+    const Data data4 = { "G", "H" };
+    const Data data5 = { "I", "J" };
+
+    model.update({data1, data2, data3, data4, data5});
+    const int changes = view.num_changes();
+    model.update({data3, data4, data5, data1, data2});
+
+    // the adjacent rows are moved at once
+    QCOMPARE(view.num_changes() - changes, 1);
+    assert_row_count(view, 5);
+    assert_equals(model.data(), view.data());
+}
+
+void TestTabModelUpdater::reorder() {
+    TabModel model;
+    TabView view(model);
+
+    const Data data1 = { "A", "B" };
+    const Data data2 = { "C", "D" };
+    const Data data3 = { "E", "F" };
+    const Data data4 = { "G", "H" };
+    const Data data5 = { "I", "J" };
+
+    const Data data_new2 = { "C", "new D" };
+
+    model.update({data5, data1, data4, data3});
+    model.update({data1, data_new2, data3, data4, data5});
+
+    assert_row_count(view, 5);
+    assert_content(view, 0, data1);
+    assert_content(view, 1, data_new2);
+    assert_content(view, 2, data3);
+    assert_content(view, 3, data4);
+    assert_content(view, 4, data5);
+    assert_equals(model.data(), view.data());
+}
+
+void TestTabModelUpdater::merge_updates() {
+    TabModel model;
+    TabView view(model);
+
+    model.update({{ "A", "B" }, { "C", "D" }, { "E", "F" }, { "G", "H" }});
+    const int changes = view.num_changes();
+    model.update({{ "A", "new B" }, { "C", "new D" }, { "E", "new F" }, { "G", "H" }});
+
+    // the adjacent changed rows are reported at once
+    QCOMPARE(view.num_changes() - changes, 1);
+    assert_equals(model.data(), view.data());
+}
+
+namespace {
+
+const int BENCHMARK_ROWS = 10000;
+
+std::vector<Data> benchmark_data__() {
+    std::vector<Data> data;
+    data.reserve(BENCHMARK_ROWS);
+    for (int i = 0; i < BENCHMARK_ROWS; ++i)
+        data.push_back({ QString::fromUtf8("task_%1").arg(i), QString::number(i) });
+    return data;
+}
+
+}
+
+void TestTabModelUpdater::benchmark_unchanged() {
+    TabModel model;
+    TabView view(model);
+
+    const auto data = benchmark_data__();
+    model.update(data);
+
+    QBENCHMARK {
+        model.update(data);
+    }
+
+    assert_equals(model.data(), view.data());
+}
+
+void TestTabModelUpdater::benchmark_mixed() {
+    TabModel model;
+    TabView view(model);
+
+    const auto data1 = benchmark_data__();
+
+    // every tenth row changed, a block of rows replaced and some rows moved
+    auto data2 = data1;
+    for (size_t i = 0; i < data2.size(); i += 10)
+        data2[i].b += QString::fromUtf8(" changed");
+    for (size_t i = 5000; i < 5100; ++i)
+        data2[i].a += QString::fromUtf8(" new");
+    std::rotate(data2.begin() + 1000, data2.begin() + 1010, data2.begin() + 9000);
+
+    QBENCHMARK {
+        model.update(data1);
+        model.update(data2);
+    }
+
+    assert_equals(model.data(), view.data());
+}
+
 QTEST_MAIN(TestTabModelUpdater)
 #include "tab_model_updater_test.moc"
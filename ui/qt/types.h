@@ -94,9 +94,6 @@ struct Project {
     QPair<double, double> resource_share;
 
     double resource_share_pct;
-
-    bool operator==(const Project &that) const;
-    bool operator!=(const Project &that) const;
 };
 
 typedef std::vector<Project> Projects;
@@ -134,11 +131,6 @@ struct Task {
     int slot = 0;
     time_t deadline = 0;
     time_t received_time = 0;
-
-    // TODO currently we use this in the tab model updater, but there we need to compare the visible one only, not all;
-    // let's improve the tab model updater and provide the compare function to it; finally, remove these operators
-    bool operator==(const Task &that) const;
-    bool operator!=(const Task &that) const;
 };
 
 typedef std::vector<Task> Tasks;
@@ -181,9 +173,6 @@ struct FileTransfer {
     double bytes_xferred;
     double size;
     double speed;
-
-    bool operator==(const FileTransfer &that) const;
-    bool operator!=(const FileTransfer &that) const;
 };
 
 typedef std::vector<FileTransfer> FileTransfers;